@@ -29,8 +29,18 @@
 #include <iostream>
 #include <iomanip>
 #include <set>
+#include <algorithm>
 
 #include <assert.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <float.h>
+#include <math.h>
+#include <locale.h>
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
 #include "argparse.hpp"
 
 
@@ -52,6 +62,20 @@ namespace argparse {
     this->err_ = ss.str();
   }
   
+  exception::ParseError::ParseError(const std::string &errmsg,
+                                    const std::vector<std::string>& suggestions)
+  : suggestions_(suggestions) {
+    std::stringstream ss;
+    ss << "ParseError: " << errmsg;
+    for (size_t i = 0; i < suggestions.size(); i++) {
+      ss << (i == 0 ? ", did you mean " : " or ") << suggestions[i];
+    }
+    if (! suggestions.empty()) {
+      ss << "?";
+    }
+    this->err_ = ss.str();
+  }
+  
   exception::KeyError::KeyError(const std::string& key,
                                 const std::string &errmsg) {
     std::stringstream ss;
@@ -91,6 +115,22 @@ namespace argparse {
     {"str",   ArgType::STR},
     {"int",   ArgType::INT},
     {"bool",  ArgType::BOOL},
+    {"int32",  ArgType::INT32},
+    {"int64",  ArgType::INT64},
+    {"uint64", ArgType::UINT64},
+    {"double", ArgType::DOUBLE},
+    {"float",  ArgType::FLOAT},
+    {"size",     ArgType::SIZE},
+    {"duration", ArgType::DURATION},
+    {"int_ranges", ArgType::INT_RANGES},
+    {"ip",   ArgType::IP},
+    {"ipv4", ArgType::IPV4},
+    {"ipv6", ArgType::IPV6},
+    {"cidr", ArgType::CIDR},
+    {"ports", ArgType::PORTS},
+    {"mac",  ArgType::MAC},
+    {"hex",    ArgType::HEX},
+    {"base64", ArgType::BASE64},
   };
 
   
@@ -100,7 +140,14 @@ namespace argparse {
     nargs_num_(1),
     type_(ArgType::STR),
     required_(false),
+    nonfinite_(false),
+    packed_(false),
+    delim_('\0'),
+    key_value_(false),
+    dup_key_(DupKey::last_wins),
+    bytes_(0),
     action_(Action::store),
+    dest_id_(0),
     proc_(proc) {
   }
   Argument::~Argument() {
@@ -162,10 +209,51 @@ namespace argparse {
     return this->name_;
   }
   
-  size_t Argument::parse_append(const Argv& args, size_t idx,
-                                std::vector<argparse_internal::Var*>* opt_list)
-  const {
+  size_t Argument::parse_append(const ArgvView& args, size_t idx,
+                                std::vector<argparse_internal::Var*>* opt_list,
+                                const StrView *inline_val) const {
+    // "--name=value" gives just one value as same as Python's argparse.
+    if (inline_val != nullptr) {
+      if (this->nargs_ == Nargs::NUMBER && this->nargs_num_ != 1) {
+        std::stringstream err;
+        err << "option '" << this->name_ << "' must have " << this->nargs_num_
+            << " arguments";
+        throw exception::ParseError(err.str());
+      }
+      this->add_value(*inline_val, opt_list);
+      return idx;
+    }
+    
+    // One value is merged into the list or the map, and no value is an
+    // error below.
+    if ((this->delim_ != '\0' || this->key_value_ ||
+         this->type_ == ArgType::CIDR) && idx < args.size() &&
+        args[idx].substr(0, 1) != "-") {
+      this->add_value(args[idx], opt_list);
+      return idx + 1;
+    }
+    
     std::vector<argparse_internal::Var*> vars;
+    // Values are added to the array directly and dropped by error if packed
+    // or converted.
+    argparse_internal::VarIntArray *packed = nullptr;
+    argparse_internal::VarAnyArray *converted = nullptr;
+    size_t array_size = 0;
+    if (this->packed_) {
+      if (opt_list->empty()) {
+        opt_list->push_back(new argparse_internal::VarIntArray(this->type_));
+      }
+      packed = static_cast<argparse_internal::VarIntArray*>(opt_list->front());
+      array_size = packed->count();
+    } else if (this->converter_) {
+      if (opt_list->empty()) {
+        opt_list->push_back(
+          new argparse_internal::VarAnyArray(this->converter_->table));
+      }
+      converted =
+        static_cast<argparse_internal::VarAnyArray*>(opt_list->front());
+      array_size = converted->count();
+    }
   
     // Defined argument number.
     size_t i = idx, e;
@@ -178,52 +266,49 @@ namespace argparse {
     }
     
     // Storing arguments.
-    while ((e == 0 || i < e) && i < args.size() &&
-           args[i].substr(0, 1) != "-") {
-      vars.emplace_back(argparse_internal::Var::build_var(args[i], this->type_));
-      i++;
+    try {
+      while ((e == 0 || i < e) && i < args.size() &&
+             args[i].substr(0, 1) != "-") {
+        if (packed) {
+          packed->push(args[i]);
+        } else if (converted) {
+          this->convert_into(converted, args[i]);
+        } else {
+          vars.emplace_back(this->build_var(args[i]));
+        }
+        i++;
+      }
+    } catch (const exception::ParseError& err) {
+      for (auto opt_ptr : vars) {
+        delete opt_ptr;
+      }
+      if (packed) {
+        packed->resize(array_size);
+      } else if (converted) {
+        converted->resize(array_size);
+      }
+      throw;
     }
     
     assert(i >= idx);
     size_t argc = i - idx;
-    assert(argc == vars.size());
-    
-    std::stringstream err;
+    assert(packed || converted || argc == vars.size());
     
-    if (this->nargs_num_ > 1 && argc != this->nargs_num_) {
-      assert(this->nargs_ == Nargs::NUMBER);
-      err << "option '" << this->name_ << "' must have " << this->nargs_num_
-          << "arguments";
-    } else if (argc == 0) { // If no argument,
-      std::string value;
-      
-      if (value.empty()) {
-        // No arguments and default values
-        if (this->nargs_ == Nargs::PLUS) {
-          err << "option '" << this->name_ << "' must have 1 or more arguments";
-        } else if (this->nargs_ == Nargs::NUMBER) {
-          assert(this->nargs_num_ == 1);
-          err << "option '" << this->name_ << "' must have 1 arguments";
-        } else if (this->nargs_ == Nargs::QUESTION) {
-          if (this->const_.empty()) {
-            vars.emplace_back(new argparse_internal::VarNull());
-          } else {
-            vars.emplace_back(argparse_internal::Var::build_var(this->const_,
-                                                                this->type_));
-          }
-        }
-      } else {
-        vars.emplace_back(argparse_internal::Var::build_var(value,
-                                                            this->type_));
-      }
-    }
+    // const of nargs '?' goes into the array of converted values.
+    const std::string err = this->check_values(argc,
+                                               converted ? opt_list : &vars);
     
     // If error, delete all Option instances and throw exception.
-    if (! err.str().empty()) {
+    if (! err.empty()) {
       for (auto opt_ptr : vars) {
         delete opt_ptr;
       }
-      throw exception::ParseError(err.str());
+      if (packed) {
+        packed->resize(array_size);
+      } else if (converted) {
+        converted->resize(array_size);
+      }
+      throw exception::ParseError(err);
     }
     
     // Move option pointers to opt_list.
@@ -234,17 +319,58 @@ namespace argparse {
     return i;
   }
   
+  std::string Argument::check_values(size_t argc,
+                                     std::vector<argparse_internal::Var*>
+                                     *opt_list) const {
+    std::stringstream err;
+    
+    if (this->nargs_num_ > 1 && argc != this->nargs_num_) {
+      assert(this->nargs_ == Nargs::NUMBER);
+      err << "option '" << this->name_ << "' must have " << this->nargs_num_
+          << "arguments";
+    } else if (argc == 0) { // If no argument,
+      // No arguments and default values
+      if (this->nargs_ == Nargs::PLUS) {
+        err << "option '" << this->name_ << "' must have 1 or more arguments";
+      } else if (this->nargs_ == Nargs::NUMBER) {
+        assert(this->nargs_num_ == 1);
+        err << "option '" << this->name_ << "' must have 1 arguments";
+      } else if (this->nargs_ == Nargs::QUESTION) {
+        if (this->const_.empty()) {
+          opt_list->emplace_back(new argparse_internal::VarNull());
+        } else {
+          this->add_value(this->const_, opt_list);
+        }
+      }
+    }
+    
+    return err.str();
+  }
+  
   size_t Argument::parse(const Argv& args, size_t idx,
                          std::vector<argparse_internal::Var*> *opt_list)
   const {
+    const ArgvView views(args.begin(), args.end());
+    return this->parse(views, idx, opt_list);
+  }
+  
+  size_t Argument::parse(const ArgvView& args, size_t idx,
+                         std::vector<argparse_internal::Var*> *opt_list,
+                         const StrView *inline_val) const {
     size_t r_idx = idx;
     argparse_internal::Var* opt = nullptr; // Just for readability.
     
+    if (inline_val != nullptr && this->action_ != Action::store &&
+        this->action_ != Action::append) {
+      throw exception::ParseError("option '" + this->name_ +
+                                  "' does not take a value");
+    }
+    
     switch(this->action_) {
       // Check double store error in Parser, no matter in Argument::parse.
       case Action::store:
       case Action::append:
-        r_idx = this->parse_append(args, idx, opt_list);
+        r_idx = this->parse_append(args, idx, opt_list, inline_val);
         break;
         
       // Check double store error in Parser, no matter in Argument::parse.
@@ -305,6 +431,7 @@ namespace argparse {
     if (this->action_ == Action::count) {
       this->type_ = ArgType::INT;
     }
+    this->proc_->invalidate();
     return *this;
   }
 
@@ -338,6 +465,7 @@ namespace argparse {
     }
 
     this->nargs_num_ = 0;
+    this->proc_->invalidate();
     
     return *this;
   }
@@ -345,6 +473,7 @@ namespace argparse {
   Argument& Argument::nargs(size_t v_nargs) {
     this->nargs_num_ = v_nargs;
     this->nargs_ = Nargs::NUMBER;
+    this->proc_->invalidate();
     return *this;
   }
 
@@ -376,6 +505,286 @@ namespace argparse {
   }
 
 
+  Argument& Argument::choices(const std::vector<std::string>& v_choices) {
+    this->choices_ = v_choices;
+    
+    // Sorted table for binary search in find_choice().
+    this->choice_order_.resize(v_choices.size());
+    for (size_t i = 0; i < v_choices.size(); i++) {
+      this->choice_order_[i] = i;
+    }
+    std::sort(this->choice_order_.begin(), this->choice_order_.end(),
+              [&v_choices](size_t a, size_t b) {
+                return v_choices[a] < v_choices[b];
+              });
+    return *this;
+  }
+  
+  const size_t Argument::NO_CHOICE;
+  
+  size_t Argument::find_choice(const StrView& val) const {
+    auto it = std::lower_bound(
+      this->choice_order_.begin(), this->choice_order_.end(), val,
+      [this](size_t i, const StrView& v) {
+        const std::string& c = this->choices_[i];
+        int r = memcmp(c.data(), v.data(), std::min(c.length(), v.size()));
+        return (r < 0 || (r == 0 && c.length() < v.size()));
+      });
+    
+    if (it != this->choice_order_.end() && val == this->choices_[*it]) {
+      return *it;
+    }
+    return NO_CHOICE;
+  }
+  
+  void Argument::complete_choice(const std::string& prefix,
+                                 std::vector<std::string> *out) const {
+    for (auto i : this->choice_order_) {
+      if (this->choices_[i].compare(0, prefix.length(), prefix) == 0) {
+        out->push_back(this->choices_[i]);
+      }
+    }
+  }
+  
+  argparse_internal::Var* Argument::build_var(const StrView& val) const {
+    if (this->converter_) {
+      auto var = new argparse_internal::VarAnyArray(this->converter_->table);
+      try {
+        this->convert_into(var, val);
+      } catch (const exception::ParseError& e) {
+        delete var;
+        throw;
+      }
+      return var;
+    }
+    
+    if (this->key_value_) {
+      auto var = new argparse_internal::VarKeyValue();
+      try {
+        this->insert_into(var, val);
+      } catch (const exception::ParseError& e) {
+        delete var;
+        throw;
+      }
+      return var;
+    }
+    
+    if (this->delim_ != '\0') {
+      auto var = new argparse_internal::VarSplit();
+      try {
+        this->split_into(var, val);
+      } catch (const exception::ParseError& e) {
+        delete var;
+        throw;
+      }
+      return var;
+    }
+    
+    if (this->packed_) {
+      auto var = new argparse_internal::VarIntArray(this->type_);
+      try {
+        var->push(val);
+      } catch (const exception::ParseError& e) {
+        delete var;
+        throw;
+      }
+      return var;
+    }
+    
+    if (this->choices_.empty()) {
+      this->check_nonfinite(val);
+      argparse_internal::Var *var =
+        argparse_internal::Var::build_var(val, this->type_);
+      if (this->bytes_ > 0 &&
+          argparse_internal::Var::decoded_size(val, this->type_) !=
+          this->bytes_) {
+        delete var;
+        throw exception::ParseError(
+          "'" + this->name_ + "' must be " + std::to_string(this->bytes_) +
+          " bytes: " + val.str());
+      }
+      return var;
+    }
+    
+    this->check_choice(val);
+    return new argparse_internal::VarChoice(val.str(), this->find_choice(val));
+  }
+  
+  void Argument::add_value(const StrView& val,
+                           std::vector<argparse_internal::Var*> *opt_list)
+    const {
+    if (this->packed_ && ! opt_list->empty()) {
+      static_cast<argparse_internal::VarIntArray*>(opt_list->front())
+        ->push(val);
+    } else if (this->converter_ && ! opt_list->empty()) {
+      this->convert_into(
+        static_cast<argparse_internal::VarAnyArray*>(opt_list->front()), val);
+    } else if (this->delim_ != '\0' && ! opt_list->empty()) {
+      this->split_into(
+        static_cast<argparse_internal::VarSplit*>(opt_list->front()), val);
+    } else if (this->key_value_ && ! opt_list->empty()) {
+      this->insert_into(
+        static_cast<argparse_internal::VarKeyValue*>(opt_list->front()), val);
+    } else if (this->type_ == ArgType::CIDR && ! this->converter_ &&
+               ! opt_list->empty()) {
+      static_cast<argparse_internal::VarCidr*>(opt_list->front())->add(val);
+    } else {
+      opt_list->push_back(this->build_var(val));
+    }
+  }
+  
+  void Argument::split_into(argparse_internal::VarSplit *var,
+                            const StrView& val) const {
+    SplitList& list = var->list();
+    const size_t first = list.size();
+    list.append(val, this->delim_);
+    if (! this->choices_.empty()) {
+      for (size_t i = first; i < list.size(); i++) {
+        const size_t c = this->find_choice(list[i]);
+        if (c == NO_CHOICE) {
+          this->check_choice(list[i]);  // throw
+        }
+        list.set_choice(c);
+      }
+    }
+  }
+  
+  void Argument::convert_into(argparse_internal::VarAnyArray *var,
+                              const StrView& val) const {
+    if (! this->choices_.empty()) {
+      this->check_choice(val);
+    }
+    try {
+      var->push(*this->converter_, val, this->find_choice(val));
+    } catch (const exception::ParseError& e) {
+      throw;
+    } catch (const std::exception& e) {
+      throw exception::ParseError("invalid value for '" + this->name_ +
+                                  "': " + val.str() + " (" + e.what() + ")");
+    }
+  }
+  
+  void Argument::insert_into(argparse_internal::VarKeyValue *var,
+                             const StrView& val) const {
+    std::string err;
+    if (! var->map().insert(val, this->dup_key_, &err)) {
+      throw exception::ParseError(err + " for '" + this->name_ + "'");
+    }
+  }
+  
+  bool Argument::check_choices(const StrView& val) const {
+    if (this->choices_.empty()) {
+      return true;
+    } else if (this->delim_ == '\0') {
+      return this->find_choice(val) != NO_CHOICE;
+    }
+    
+    const char *p = val.data(), *end = val.data() + val.size();
+    while (p < end) {
+      const char *q = static_cast<const char*>(memchr(p, this->delim_,
+                                                      end - p));
+      q = (q ? q : end);
+      if (q > p && this->find_choice(StrView(p, q - p)) == NO_CHOICE) {
+        return false;
+      }
+      p = q + 1;
+    }
+    return true;
+  }
+  
+  size_t Argument::count_items(const StrView& val) const {
+    if (this->type_ == ArgType::CIDR && ! this->converter_) {
+      // Blocks are separated by ',' and an empty one is invalid.
+      return std::count(val.data(), val.data() + val.size(), ',') + 1;
+    } else if (this->delim_ == '\0') {
+      return 1;
+    }
+    // Same as SplitList::append, empty items are dropped.
+    size_t n = 0;
+    const char *p = val.data(), *end = val.data() + val.size();
+    while (p < end) {
+      const char *q = static_cast<const char*>(memchr(p, this->delim_,
+                                                      end - p));
+      q = (q ? q : end);
+      n += (q > p);
+      p = q + 1;
+    }
+    return n;
+  }
+  
+  bool Argument::check_value(const StrView& val, bool convert) const {
+    if (this->key_value_) {
+      const void *eq = memchr(val.data(), '=', val.size());
+      return (eq != nullptr && eq != val.data());
+    }
+    if (this->converter_ && ! convert) {
+      return true;
+    } else if (this->converter_) {
+      if (! this->check_choices(val)) {
+        return false;
+      }
+      try {
+        this->converter_->check(val);
+      } catch (const std::exception& e) {
+        return false;
+      }
+      return true;
+    }
+    return (argparse_internal::Var::check(val, this->type_) &&
+            (this->nonfinite_ || ! this->is_float() ||
+             ! argparse_internal::Var::is_nonfinite(val)) &&
+            (this->bytes_ == 0 ||
+             argparse_internal::Var::decoded_size(val, this->type_) ==
+             this->bytes_));
+  }
+  
+  void Argument::check_nonfinite(const StrView& val) const {
+    if (! this->nonfinite_ && this->is_float() &&
+        argparse_internal::Var::is_nonfinite(val)) {
+      throw exception::ParseError("nan and inf are not allowed for '" +
+                                  this->name_ + "': " + val.str());
+    }
+  }
+  
+  void Argument::check_choice(const StrView& val) const {
+    if (this->find_choice(val) == NO_CHOICE) {
+      std::stringstream err;
+      err << "invalid choice for '" << this->name_ << "': " << val.str()
+          << " (choose from";
+      for (size_t i = 0; i < this->choices_.size(); i++) {
+        err << (i > 0 ? ", " : " ") << this->choices_[i];
+      }
+      err << ")";
+      throw exception::ParseError(err.str());
+    }
+  }
+  
+  Argument& Argument::nonfinite(bool allow) {
+    this->nonfinite_ = allow;
+    return *this;
+  }
+  
+  Argument& Argument::packed(bool pack) {
+    this->packed_ = pack;
+    return *this;
+  }
+  
+  Argument& Argument::key_value(DupKey dup) {
+    this->key_value_ = true;
+    this->dup_key_ = dup;
+    return *this;
+  }
+  
+  Argument& Argument::bytes(size_t n) {
+    this->bytes_ = n;
+    return *this;
+  }
+  
+  Argument& Argument::split(char delim) {
+    this->delim_ = delim;
+    return *this;
+  }
+  
   Argument& Argument::required(bool req) {
     this->required_ = req;
     return *this;
@@ -393,6 +802,7 @@ namespace argparse {
 
   Argument& Argument::dest(const std::string &v_dest) {
     this->dest_ = v_dest;
+    this->proc_->invalidate();
     return *this;
   }
 
@@ -418,6 +828,88 @@ namespace argparse {
       }
     }
     
+    if (this->converter_ && this->action_ != Action::store &&
+        this->action_ != Action::append) {
+      throw argparse::exception::ConfigureError("type converter is supported "
+                                                "only by store and append",
+                                                this->name_);
+    }
+    
+    // All converted values are in one array, nargs '?' can't put null.
+    if (this->converter_ && this->nargs_ == Nargs::QUESTION &&
+        this->const_.empty()) {
+      throw argparse::exception::ConfigureError("type converter with nargs "
+                                                "'?' needs const",
+                                                this->name_);
+    }
+    
+    if (! this->choices_.empty()) {
+      if ((this->action_ != Action::store && this->action_ != Action::append) ||
+          this->type_ != ArgType::STR) {
+        throw argparse::exception::ConfigureError("choices are supported "
+                                                  "only by 'str' type of "
+                                                  "store and append",
+                                                  this->name_);
+      }
+      if ((! this->default_.empty() && ! this->check_choices(this->default_)) ||
+          (! this->const_.empty() && ! this->check_choices(this->const_))) {
+        throw argparse::exception::ConfigureError("default and const must be "
+                                                  "one of choices",
+                                                  this->name_);
+      }
+    }
+    
+    if (this->packed_ &&
+        ((this->action_ != Action::store && this->action_ != Action::append) ||
+         (this->type_ != ArgType::INT && this->type_ != ArgType::INT32 &&
+          this->type_ != ArgType::INT64) ||
+         this->nargs_ == Nargs::QUESTION || this->converter_ ||
+         ! this->choices_.empty())) {
+      throw argparse::exception::ConfigureError("packed is supported only by "
+                                                "int types of store and "
+                                                "append without nargs '?', "
+                                                "choices and converter",
+                                                this->name_);
+    }
+    
+    if (this->delim_ != '\0' &&
+        ((this->action_ != Action::store && this->action_ != Action::append) ||
+         this->type_ != ArgType::STR || this->nargs_ != Nargs::NUMBER ||
+         this->nargs_num_ != 1 || this->converter_ || this->packed_)) {
+      throw argparse::exception::ConfigureError("split is supported only by "
+                                                "'str' type of store and "
+                                                "append with one argument",
+                                                this->name_);
+    }
+    
+    if (this->key_value_ &&
+        ((this->action_ != Action::store && this->action_ != Action::append) ||
+         this->type_ != ArgType::STR || this->nargs_ != Nargs::NUMBER ||
+         this->nargs_num_ != 1 || this->converter_ || this->packed_ ||
+         this->delim_ != '\0' || ! this->choices_.empty())) {
+      throw argparse::exception::ConfigureError("key_value is supported only "
+                                                "by 'str' type of store and "
+                                                "append with one argument",
+                                                this->name_);
+    }
+    
+    if (this->bytes_ > 0 &&
+        ((this->type_ != ArgType::HEX && this->type_ != ArgType::BASE64) ||
+         this->converter_)) {
+      throw argparse::exception::ConfigureError("bytes is supported only by "
+                                                "'hex' and 'base64' type",
+                                                this->name_);
+    }
+    
+    if (this->type_ == ArgType::CIDR && ! this->converter_ &&
+        ((this->action_ != Action::store && this->action_ != Action::append) ||
+         this->nargs_ != Nargs::NUMBER || this->nargs_num_ != 1)) {
+      throw argparse::exception::ConfigureError("'cidr' type is supported "
+                                                "only by store and append "
+                                                "with one argument",
+                                                this->name_);
+    }
+    
     if (this->action_ == Action::count) {
       if (this->type_ != ArgType::INT) {
         throw argparse::exception::ConfigureError("action 'count' must have "
@@ -461,6 +953,15 @@ namespace argparse {
       meta = ((this->metavar_.empty()) ? usage : this->metavar_);
     }
     
+    if (this->metavar_.empty() && ! this->choices_.empty()) {
+      // e.g. "{read,write}" as Python's argparse.
+      meta = "{";
+      for (size_t i = 0; i < this->choices_.size(); i++) {
+        meta += (i > 0 ? "," : "") + this->choices_[i];
+      }
+      meta += "}";
+    }
+    
     if (this->action_ == Action::store || this->action_ == Action::append) {
       if (ss.str().length() > 0) {
         ss << " ";
@@ -497,6 +998,36 @@ namespace argparse {
     return ss.str();
   }
 
+  const size_t Argument::NARGS_UNLIMITED;
+  
+  size_t Argument::min_nargs() const {
+    if (this->action_ != Action::store && this->action_ != Action::append) {
+      return 0;
+    }
+    
+    switch (this->nargs_) {
+      case Nargs::NUMBER:   return this->nargs_num_;
+      case Nargs::PLUS:     return 1;
+      case Nargs::QUESTION: return 0;
+      case Nargs::ASTERISK: return 0;
+    }
+    return 0;
+  }
+  
+  size_t Argument::max_nargs() const {
+    if (this->action_ != Action::store && this->action_ != Action::append) {
+      return 0;
+    }
+    
+    switch (this->nargs_) {
+      case Nargs::NUMBER:   return this->nargs_num_;
+      case Nargs::QUESTION: return 1;
+      case Nargs::PLUS:     return NARGS_UNLIMITED;
+      case Nargs::ASTERISK: return NARGS_UNLIMITED;
+    }
+    return 0;
+  }
+  
   std::string Argument::usage() const {
     return this->build_usage(this->name_);
   }
@@ -535,21 +1066,100 @@ namespace argparse {
     return arg;
   }
 
-  Values Parser::parse_args(const Argv& args) const {
-    Values val = this->proc_->parse_args(args);
+  Values Parser::parse(const ArgvView& args, const ArgvSpan *rest,
+                       ArgvView *unknown) const {
+    // Hidden completion mode, "prog __complete <cword> <words...>", is
+    // answered here before returning to application code.
+    if (args.size() >= 3 && args[1] == "__complete") {
+      const ArgvView words(args.begin() + 3, args.end());
+      size_t cword = strtoul(args[2].str().c_str(), nullptr, 10);
+      this->proc_->complete(words, cword, this->output_);
+      
+      std::shared_ptr<VarMap> ptr = std::make_shared<VarMap>();
+      ptr->set_complete_mode(true);
+      return Values(ptr);
+    }
+    
+    Values val = this->proc_->parse_args(args, rest, unknown);
     if (val.is_help_mode()) {
       this->help();
     }
     return val;
   }
+  
+  Values Parser::parse_args(const Argv& args) const {
+    const ArgvView views(args.begin(), args.end());
+    return this->parse(views, nullptr, nullptr);
+  }
 
   Values Parser::parse_args(int argc, char *argv[]) const {
-    Argv args;
-    for (int i = 0; i < argc; i++) {
-      args.emplace_back(argv[i]);
+    return this->parse_known_args(argc, argv, nullptr);
+  }
+  
+  Values Parser::parse_known_args(const Argv& args, ArgvView *unknown) const {
+    const ArgvView views(args.begin(), args.end());
+    return this->parse(views, nullptr, unknown);
+  }
+  
+  // Build views of argv with limits checked on the way, then an argument
+  // over limits is found without measuring the following ones. Option
+  // values never start with '-', then the first "--" is always the
+  // terminator. If at_terminator, views end there and arguments after it
+  // are only counted, then they can be passed without copy.
+  static bool read_argv(const Limits& limits, int argc, char *argv[],
+                        bool at_terminator, ArgvView *views,
+                        size_t *err_idx, std::string *err) {
+    if (! argparse_internal::LimitCounter(limits).skip(argc, err)) {
+      *err_idx = limits.max_args;
+      return false;
     }
     
-    return this->parse_args(args);
+    argparse_internal::LimitCounter counter(limits);
+    views->reserve(argc);
+    for (int i = 0; i < argc; i++) {
+      if (at_terminator && i > 0 && strcmp(argv[i], "--") == 0) {
+        break;
+      }
+      size_t len;
+      if (! counter.add(argv[i], &len, err)) {
+        *err_idx = i;
+        return false;
+      }
+      views->push_back(StrView(argv[i], len));
+    }
+    return true;
+  }
+  
+  // ParseError if argv is over limits.
+  static ArgvView read_argv(const Limits& limits, int argc, char *argv[],
+                            bool at_terminator) {
+    ArgvView views;
+    size_t err_idx;
+    std::string err;
+    if (! read_argv(limits, argc, argv, at_terminator, &views, &err_idx,
+                    &err)) {
+      throw exception::ParseError(err);
+    }
+    return views;
+  }
+  
+  Values Parser::parse_known_args(int argc, char *argv[],
+                                  ArgvView *unknown) const {
+    // Words for completion should be kept as it is.
+    const bool complete = (argc >= 2 && strcmp(argv[1], "__complete") == 0);
+    const ArgvView views = read_argv(this->proc_->limits(), argc, argv,
+                                     ! complete);
+    const int end = static_cast<int>(views.size());
+    if (end < argc) {
+      const ArgvSpan rest(argv + end + 1, argc - end - 1);
+      return this->parse(views, &rest, unknown);
+    }
+    return this->parse(views, nullptr, unknown);
+  }
+  
+  Values Parser::parse_known_args(const ArgvView& args,
+                                  ArgvView *unknown) const {
+    return this->parse(args, nullptr, unknown);
   }
   
   void Parser::usage() const {
@@ -561,202 +1171,2844 @@ namespace argparse {
     this->proc_->help(this->output_);
   }
   
-  void Parser::set_output(std::ostream *output) {
-    this->output_ = output;
+  void Parser::completion_script(const std::string& shell) const {
+    // Shell function names can not have characters such as '.' and '/'.
+    std::string fname = "_";
+    for (auto c : this->prog_name_) {
+      fname += (isalnum(c) ? c : '_');
+    }
+    fname += "_complete";
+    const std::string& prog = this->prog_name_;
+    std::ostream& out = *(this->output_);
+    
+    if (shell == "bash") {
+      out << fname << "() {" << std::endl
+          << "  local IFS=$'\\n'" << std::endl
+          << "  COMPREPLY=($(" << prog << " __complete \"$COMP_CWORD\" "
+          << "\"${COMP_WORDS[@]}\" 2>/dev/null))" << std::endl
+          << "}" << std::endl
+          << "complete -o default -F " << fname << " " << prog << std::endl;
+    } else if (shell == "zsh") {
+      out << "#compdef " << prog << std::endl
+          << fname << "() {" << std::endl
+          << "  local -a reply" << std::endl
+          << "  reply=(${(f)\"$(" << prog << " __complete $((CURRENT - 1)) "
+          << "\"${words[@]}\" 2>/dev/null)\"})" << std::endl
+          << "  if (( ${#reply} )); then" << std::endl
+          << "    compadd -a reply" << std::endl
+          << "  else" << std::endl
+          << "    _files" << std::endl
+          << "  fi" << std::endl
+          << "}" << std::endl
+          << "compdef " << fname << " " << prog << std::endl;
+    } else if (shell == "fish") {
+      out << "function " << fname << std::endl
+          << "    set -l words (commandline -opc) (commandline -ct)" << std::endl
+          << "    " << prog << " __complete (math (count $words) - 1) $words "
+          << "2>/dev/null" << std::endl
+          << "end" << std::endl
+          << "complete -c " << prog << " -a '(" << fname << ")'" << std::endl;
+    } else {
+      throw exception::ConfigureError("not supported shell", shell);
+    }
   }
-
   
-  // ========================================================
-  // argparse::Values
-  //
-  const std::vector<argparse_internal::Var*>&
-  Values::get_var_arr(const VarMap& varmap, const std::string& key) {
-    auto it = varmap.find(key);
-    if (it == varmap.end()) {
-      throw argparse::exception::KeyError(key, "not found in options");
+  void Parser::allow_abbrev(bool allow) {
+    this->proc_->set_allow_abbrev(allow);
+  }
+  
+  size_t Parser::parse_events(const ArgvView& args,
+                              const EventHandler& handler) const {
+    argparse_internal::EventCursor cursor(*this->proc_, args);
+    Event ev;
+    
+    while (cursor.next(&ev)) {
+      if (! handler(ev)) {
+        return cursor.position();
+      }
     }
     
-    return *(it->second);
+    if (cursor.error() != ErrorCode::none) {
+      cursor.throw_error();
+    }
+    return cursor.position();
   }
   
-  const argparse_internal::Var& Values::get_var(const VarMap& varmap,
-                                                const std::string& key,
-                                                size_t idx) {
-    auto arr = get_var_arr(varmap, key);
-    if (arr.size() <= idx) {
-      throw argparse::exception::IndexError(key);
+  size_t Parser::parse_events(int argc, char *argv[],
+                              const EventHandler& handler) const {
+    const ArgvView views = read_argv(this->proc_->limits(), argc, argv,
+                                     false);
+    return this->parse_events(views, handler);
+  }
+  
+  ParseStatus Parser::validate(const ArgvView& args) const {
+    argparse_internal::EventCursor cursor(*this->proc_, args, false);
+    Event ev;
+    while (cursor.next(&ev)) {
     }
     
-    return *(arr[idx]);
+    ParseStatus status = {cursor.error(), cursor.error_index(),
+                          cursor.error_argument()};
+    return status;
   }
   
+  ParseStatus Parser::validate(const Argv& args) const {
+    const ArgvView views(args.begin(), args.end());
+    return this->validate(views);
+  }
   
-  Values::Values(std::shared_ptr<VarMap> varmap) : varmap_(varmap) {
+  ParseStatus Parser::validate(int argc, char *argv[]) const {
+    ArgvView views;
+    size_t err_idx;
+    std::string err;
+    if (! read_argv(this->proc_->limits(), argc, argv, false, &views,
+                    &err_idx, &err)) {
+      ParseStatus status = {ErrorCode::limit_exceeded, err_idx, nullptr};
+      return status;
+    }
+    return this->validate(views);
   }
   
-  Values::Values(const Values& obj) : varmap_(obj.varmap_) {
+  std::string Parser::error_message(const ArgvView& args) const {
+    try {
+      this->parse_events(args, [](const Event& ev) { return true; });
+    } catch (const exception::ParseError& e) {
+      return e.what();
+    }
+    return "";
   }
   
-  Values::~Values() {
+  size_t Parser::dest_id(const std::string& dest) const {
+    this->proc_->freeze();
+    return this->proc_->dest_id(dest);
   }
   
-  Values& Values::operator=(const Values &obj) {
-    this->varmap_ = obj.varmap_;
-    return *this;
+  void Parser::set_limits(const Limits& limits) {
+    this->proc_->set_limits(limits);
   }
   
-  const std::string& Values::operator[](const std::string& key) const {
-    return this->to_str(key, 0);
+  void Parser::set_output(std::ostream *output) {
+    this->output_ = output;
   }
+
   
-  const std::string& Values::get(const std::string& key, size_t idx) const {
-    return this->to_str(key, idx);
+  // ========================================================
+  // argparse::EventRange
+  //
+  struct EventRange::State {
+    const ArgvView views;  // only for argv of main()
+    argparse_internal::EventCursor cursor;
+    Event event;
+    bool started;
+    bool valid;
+    
+    State(const argparse_internal::ArgumentProcessor& proc,
+          const ArgvView& args)
+      : cursor(proc, args), started(false), valid(false) {}
+    State(const argparse_internal::ArgumentProcessor& proc, ArgvView&& v)
+      : views(std::move(v)), cursor(proc, this->views), started(false),
+        valid(false) {}
+  };
+  
+  EventRange::EventRange(State *state) : state_(state) {
   }
   
-  const std::string& Values::to_str(const std::string& key, size_t idx) const {
-    const argparse_internal::Var& v = Values::get_var(*(this->varmap_.get()),
-                                                      key, idx);
-    return v.to_s();
+  EventRange::EventRange(EventRange&& obj) : state_(std::move(obj.state_)) {
   }
   
-  int Values::to_int(const std::string& key, size_t idx) const {
-    const argparse_internal::Var& v = Values::get_var(*(this->varmap_.get()),
-                                                      key, idx);
-    return v.to_i();
+  EventRange::~EventRange() {
   }
   
-  size_t Values::size(const std::string &key) const {
-    try {
-      auto arr = get_var_arr(*(this->varmap_.get()), key);
-      return arr.size();
-    } catch (exception::KeyError &e) {
+  void EventRange::advance() {
+    State& st = *(this->state_);
+    st.started = true;
+    st.valid = st.cursor.next(&st.event);
+    if (! st.valid &&
+        st.cursor.error() != ErrorCode::none) {
+      st.cursor.throw_error();
+    }
+  }
+  
+  EventRange::iterator EventRange::begin() {
+    if (! this->state_->started) {
+      this->advance();
+    }
+    return iterator(this);
+  }
+  
+  size_t EventRange::position() const {
+    return this->state_->cursor.position();
+  }
+  
+  EventRange Parser::events(const ArgvView& args) const {
+    return EventRange(new EventRange::State(*this->proc_, args));
+  }
+  
+  EventRange Parser::events(int argc, char *argv[]) const {
+    ArgvView views = read_argv(this->proc_->limits(), argc, argv, false);
+    return EventRange(new EventRange::State(*this->proc_,
+                                            std::move(views)));
+  }
+  
+  const Event& EventRange::iterator::operator*() const {
+    return this->range_->state_->event;
+  }
+  
+  bool EventRange::iterator::operator==(const iterator& obj) const {
+    // All iterators of a range are at same position, then only end or not.
+    const bool end1 = (this->range_ == nullptr ||
+                       ! this->range_->state_->valid);
+    const bool end2 = (obj.range_ == nullptr || ! obj.range_->state_->valid);
+    return (end1 == end2);
+  }
+  
+  
+  // ========================================================
+  // argparse::ParserGroup
+  //
+  const size_t ParserGroup::NO_OWNER;
+  
+  struct ParserGroup::Index {
+    std::map<const std::string, Route> routes;
+    size_t seq_owner;
+    bool allow_abbrev;  // only if all parsers allow it
+    Limits limits;      // the strictest of all parsers
+    argparse_internal::NameTrie trie;
+    argparse_internal::BKTree bktree;  // built at first suggestion
+    Index() : seq_owner(NO_OWNER), allow_abbrev(true) {}
+  };
+  
+  // Strictest of two limits where 0 is unlimited.
+  static size_t min_limit(size_t a, size_t b) {
+    return (a == 0 ? b : (b == 0 ? a : std::min(a, b)));
+  }
+  
+  ParserGroup::ParserGroup()
+  : index_(new Index()), generation_(0), bktree_built_(false) {}
+  
+  ParserGroup::~ParserGroup() {}
+  
+  size_t ParserGroup::generation() const {
+    // Generations only count up, then the sum changes if any Parser is
+    // configured again.
+    size_t gen = 0;
+    for (auto psr : this->parsers_) {
+      gen += psr->proc_->generation();
+    }
+    return gen;
+  }
+  
+  void ParserGroup::build() const {
+    // Build aside and replace index_ at last, then the group is still
+    // usable with old options after ConfigureError.
+    std::unique_ptr<Index> index(new Index());
+    for (size_t i = 0; i < this->parsers_.size(); i++) {
+      const argparse_internal::ArgumentProcessor& proc =
+        *(this->parsers_[i]->proc_);
+      
+      for (const auto& it : proc.options()) {
+        const bool help = (it.second->get_action() == Action::help);
+        auto rit = index->routes.find(it.first);
+        if (rit != index->routes.end()) {
+          if (! help || rit->second.owner != NO_OWNER) {
+            throw exception::ConfigureError("option is defined by multiple "
+                                            "parsers", it.first);
+          }
+          continue;
+        }
+        Route r = {(help ? NO_OWNER : i), it.second.get()};
+        index->routes.insert(std::make_pair(it.first, r));
+        index->trie.insert((it.first.length() > 1 ? "--" : "-") + it.first);
+      }
+      
+      if (proc.has_sequence()) {
+        if (index->seq_owner != NO_OWNER) {
+          throw exception::ConfigureError("sequence arguments are defined by "
+                                          "multiple parsers",
+                                          this->parsers_[i]->prog_name_);
+        }
+        index->seq_owner = i;
+      }
+      
+      index->allow_abbrev = (index->allow_abbrev && proc.allow_abbrev());
+      const Limits& l = proc.limits();
+      index->limits.max_args = min_limit(index->limits.max_args, l.max_args);
+      index->limits.max_bytes = min_limit(index->limits.max_bytes,
+                                          l.max_bytes);
+      index->limits.max_cluster = min_limit(index->limits.max_cluster,
+                                            l.max_cluster);
+    }
+    
+    this->index_.swap(index);
+    this->bktree_built_.store(false, std::memory_order_relaxed);
+  }
+  
+  void ParserGroup::freeze() const {
+    const size_t gen = this->generation();
+    if (this->generation_.load(std::memory_order_acquire) == gen) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(this->freeze_mutex_);
+    if (this->generation_.load(std::memory_order_relaxed) != gen) {
+      this->build();
+      this->generation_.store(gen, std::memory_order_release);
+    }
+  }
+  
+  void ParserGroup::attach(const Parser& psr) {
+    this->parsers_.push_back(&psr);
+    try {
+      std::lock_guard<std::mutex> lock(this->freeze_mutex_);
+      this->build();
+      this->generation_.store(this->generation(), std::memory_order_release);
+    } catch (...) {
+      this->parsers_.pop_back();
+      throw;
+    }
+  }
+  
+  const argparse_internal::BKTree& ParserGroup::suggestion_tree() const {
+    Index& index = *(this->index_);
+    if (this->bktree_built_.load(std::memory_order_acquire)) {
+      return index.bktree;
+    }
+    std::lock_guard<std::mutex> lock(this->freeze_mutex_);
+    if (! this->bktree_built_.load(std::memory_order_relaxed)) {
+      index.bktree.clear();
+      for (const auto& it : index.routes) {
+        if (it.first.length() > 1) {
+          index.bktree.insert("--" + it.first);
+        }
+      }
+      this->bktree_built_.store(true, std::memory_order_release);
+    }
+    return index.bktree;
+  }
+  
+  const ParserGroup::Route* ParserGroup::resolve(const std::string& key,
+                                                 bool is_long,
+                                                 bool *ambiguous) const {
+    // Same as ArgumentProcessor::resolve_option over all parsers.
+    *ambiguous = false;
+    const Index& index = *(this->index_);
+    auto it = index.routes.find(key);
+    if (it != index.routes.end()) {
+      return &(it->second);
+    }
+    
+    if (index.allow_abbrev && is_long) {
+      std::string name;
+      size_t n = index.trie.resolve("--" + key, &name);
+      if (n == 1) {
+        return &(index.routes.find(name.substr(2))->second);
+      }
+      *ambiguous = (n > 1);
+    }
+    return nullptr;
+  }
+  
+  size_t ParserGroup::route(const ArgvView& args, size_t idx,
+                            const std::string& key, bool is_long,
+                            const std::vector<std::shared_ptr<VarMap> >& maps,
+                            const StrView *inline_val) const {
+    typedef argparse_internal::ArgumentProcessor Proc;
+    
+    bool ambiguous;
+    const Route *r = this->resolve(key, is_long, &ambiguous);
+    if (r == nullptr) {
+      if (ambiguous) {
+        Proc::throw_ambiguous(this->index_->trie, key);
+      }
+      Proc::throw_not_found(this->suggestion_tree(), key);
+    }
+    
+    if (r->owner == NO_OWNER) {
+      for (const auto& ptr : maps) {
+        ptr->set_help_mode(true);
+      }
+      return idx;
+    }
+    
+    return Proc::parse_option(args, idx, *(r->arg), key,
+                              maps[r->owner].get(), inline_val);
+  }
+  
+  std::vector<Values> ParserGroup::parse(const ArgvView& args,
+                                         const ArgvSpan *rest) const {
+    typedef argparse_internal::ArgumentProcessor Proc;
+    
+    this->freeze();
+    // Same as Parser::parse, words are completed over all options.
+    if (! this->parsers_.empty() && args.size() >= 3 &&
+        args[1] == "__complete") {
+      const ArgvView words(args.begin() + 3, args.end());
+      size_t cword = strtoul(args[2].str().c_str(), nullptr, 10);
+      Proc::complete(this->index_->trie,
+                     [this](const std::string& key, bool is_long) {
+                       bool ambiguous;
+                       const Route *r = this->resolve(key, is_long,
+                                                      &ambiguous);
+                       return ((r == nullptr || r->arg->get_choices().empty())
+                               ? nullptr : r->arg);
+                     }, words, cword, this->parsers_[0]->output_);
+      
+      std::vector<Values> vals;
+      for (size_t i = 0; i < this->parsers_.size(); i++) {
+        std::shared_ptr<VarMap> ptr = std::make_shared<VarMap>();
+        ptr->set_complete_mode(true);
+        vals.push_back(Values(ptr));
+      }
+      return vals;
+    }
+    
+    // Arguments are checked once with the strictest limits, and max_values
+    // is checked by VarMap of each parser.
+    Proc::check_limits(this->index_->limits, args);
+    std::vector<std::shared_ptr<VarMap> > maps;
+    for (auto psr : this->parsers_) {
+      maps.push_back(psr->proc_->prepare());
+    }
+    std::vector<size_t> seq;
+    
+    for (size_t idx = 1; idx < args.size(); ) {
+      std::string key;
+      StrView val;
+      bool has_val;
+      
+      switch (Proc::split_token(args[idx], &key, &val, &has_val)) {
+        case argparse_internal::TokenType::terminator:
+          for (const auto& ptr : maps) {
+            ptr->set_rest(args, idx + 1);
+          }
+          idx = args.size();
+          break;
+          
+        case argparse_internal::TokenType::long_option:
+          idx = this->route(args, idx + 1, key, true, maps,
+                            (has_val ? &val : nullptr));
+          break;
+          
+        case argparse_internal::TokenType::short_options:
+          idx = idx + 1;
+          for (size_t c = 0; c < key.length(); c++) {
+            idx = this->route(args, idx, key.substr(c, 1), false, maps,
+                              nullptr);
+          }
+          break;
+          
+        case argparse_internal::TokenType::sequence:
+          seq.push_back(idx);
+          idx++;
+          break;
+      }
+    }
+    
+    const size_t seq_owner = this->index_->seq_owner;
+    if (seq_owner != NO_OWNER) {
+      this->parsers_[seq_owner]->proc_->parse_sequences(
+        args, seq, maps[seq_owner].get(), nullptr);
+    } else if (! seq.empty()) {
+      throw exception::ParseError("too long arguments after " +
+                                  args[seq[0]].str());
+    }
+    
+    std::vector<Values> vals;
+    for (size_t i = 0; i < this->parsers_.size(); i++) {
+      vals.push_back(this->parsers_[i]->proc_->finish(maps[i], rest));
+    }
+    if (! vals.empty() && vals[0].is_help_mode()) {
+      this->help();
+    }
+    return vals;
+  }
+  
+  std::vector<Values> ParserGroup::parse_args(const Argv& args) const {
+    const ArgvView views(args.begin(), args.end());
+    return this->parse(views, nullptr);
+  }
+  
+  std::vector<Values> ParserGroup::parse_args(int argc, char *argv[]) const {
+    this->freeze();
+    const bool complete = (argc >= 2 && strcmp(argv[1], "__complete") == 0);
+    const ArgvView views = read_argv(this->index_->limits, argc, argv,
+                                     ! complete);
+    const int end = static_cast<int>(views.size());
+    if (end < argc) {
+      const ArgvSpan rest(argv + end + 1, argc - end - 1);
+      return this->parse(views, &rest);
+    }
+    return this->parse(views, nullptr);
+  }
+  
+  
+  
+  void ParserGroup::usage() const {
+    if (this->parsers_.empty()) {
+      return;
+    }
+    std::vector<const argparse_internal::ArgumentProcessor*> procs;
+    for (auto psr : this->parsers_) {
+      procs.push_back(psr->proc_);
+    }
+    const Parser& first = *(this->parsers_[0]);
+    argparse_internal::ArgumentProcessor::usage(first.prog_name_, procs,
+                                                first.output_);
+  }
+  
+  void ParserGroup::help() const {
+    if (this->parsers_.empty()) {
+      return;
+    }
+    std::vector<const argparse_internal::ArgumentProcessor*> procs;
+    for (auto psr : this->parsers_) {
+      procs.push_back(psr->proc_);
+    }
+    this->usage();
+    argparse_internal::ArgumentProcessor::help(procs,
+                                               this->parsers_[0]->output_);
+  }
+  
+  
+  // ========================================================
+  // argparse::PushParser
+  //
+  PushParser::PushParser(const Parser& psr)
+  : psr_(psr), varmap_(psr.proc_->prepare()), passthrough_(false),
+    counter_(new argparse_internal::LimitCounter(psr.proc_->limits())) {
+    std::string err;
+    this->counter_->skip(1, &err);  // program name
+  }
+  
+  PushParser::~PushParser() {
+  }
+  
+  void PushParser::open_option(const std::string& key, bool is_long,
+                               const StrView *inline_val) {
+    typedef argparse_internal::ArgumentProcessor Proc;
+    const Argument& arg = this->psr_.proc_->find_option(key, is_long);
+    
+    if ((arg.get_action() != Action::store &&
+         arg.get_action() != Action::append) || inline_val != nullptr) {
+      // No more values from following arguments.
+      Proc::parse_option(ArgvView(), 0, arg, key, this->varmap_.get(),
+                         inline_val);
+      return;
+    }
+    
+    Pending p = {&arg, Proc::dest_vars(arg, key, this->varmap_.get()), 0};
+    this->pending_.push_back(p);
+  }
+  
+  void PushParser::close_options() {
+    for (const auto& p : this->pending_) {
+      const std::string err = p.arg->check_values(p.count, p.vars);
+      if (! err.empty()) {
+        this->pending_.clear();
+        throw exception::ParseError(err);
+      }
+    }
+    this->pending_.clear();
+  }
+  
+  void PushParser::feed(const std::string& token) {
+    typedef argparse_internal::ArgumentProcessor Proc;
+    
+    std::string err;
+    if (! this->counter_->add(token, &err)) {
+      throw exception::ParseError(err);
+    }
+    
+    if (this->passthrough_) {
+      this->rest_.push_back(token);
+      return;
+    }
+    
+    std::string key;
+    StrView val;
+    bool has_val;
+    argparse_internal::TokenType type = Proc::split_token(token, &key, &val,
+                                                          &has_val);
+    
+    if (type == argparse_internal::TokenType::sequence) {
+      // Skip options which already have enough values, then give it.
+      while (! this->pending_.empty() &&
+             this->pending_.front().count ==
+             this->pending_.front().arg->max_nargs()) {
+        this->pending_.erase(this->pending_.begin());
+      }
+      
+      if (this->pending_.empty()) {
+        this->seq_.push_back(token);
+      } else {
+        Pending& p = this->pending_.front();
+        p.arg->add_value(token, p.vars);
+        p.count++;
+        this->varmap_->check_values(p.arg->get_dest(), *p.vars);
+      }
+      return;
+    }
+    
+    this->close_options();
+    
+    switch (type) {
+      case argparse_internal::TokenType::terminator:
+        this->passthrough_ = true;
+        break;
+        
+      case argparse_internal::TokenType::long_option:
+        this->open_option(key, true, (has_val ? &val : nullptr));
+        break;
+        
+      case argparse_internal::TokenType::short_options:
+        for (size_t c = 0; c < key.length(); c++) {
+          this->open_option(key.substr(c, 1), false, nullptr);
+        }
+        break;
+        
+      case argparse_internal::TokenType::sequence:
+        assert(0);
+        break;
+    }
+  }
+  
+  Values PushParser::finish() {
+    this->close_options();
+    
+    const ArgvView views(this->seq_.begin(), this->seq_.end());
+    std::vector<size_t> seq(views.size());
+    for (size_t i = 0; i < seq.size(); i++) {
+      seq[i] = i;
+    }
+    this->psr_.proc_->parse_sequences(views, seq, this->varmap_.get(),
+                                      nullptr);
+    
+    if (this->passthrough_) {
+      this->varmap_->set_rest(this->rest_);
+    }
+    
+    Values val = this->psr_.proc_->finish(this->varmap_, nullptr);
+    if (val.is_help_mode()) {
+      this->psr_.help();
+    }
+    return val;
+  }
+  
+  
+  // ========================================================
+  // argparse::ArgvSpan, argparse::VarMap
+  //
+  char* const ArgvSpan::EMPTY_[1] = {nullptr};
+  
+  void VarMap::set_rest(const ArgvView& args, size_t idx) {
+    // Each view is a whole argument, then it's terminated by '\0'.
+    this->rest_buf_.clear();
+    for (size_t i = idx; i < args.size(); i++) {
+      this->rest_buf_.push_back(const_cast<char*>(args[i].data()));
+    }
+    this->rest_buf_.push_back(nullptr);
+    this->rest_ = ArgvSpan(this->rest_buf_.data(), this->rest_buf_.size() - 1);
+  }
+  
+  
+  VarMap::~VarMap() {
+    for (auto& it : *this) {
+      for (auto var : *(it.second)) {
+        delete var;
+      }
+      delete it.second;
+    }
+  }
+  
+  void VarMap::check_values(const std::string& dest,
+                            const std::vector<argparse_internal::Var*>& vars)
+    const {
+    if (this->max_values_ > 0 &&
+        VarMap::count_values(vars) > this->max_values_) {
+      throw exception::ParseError("too many values for " + dest +
+                                  ", limit is " +
+                                  std::to_string(this->max_values_));
+    }
+  }
+  
+  size_t VarMap::count_values(const std::vector<argparse_internal::Var*>&
+                              vars) {
+    // Packed values are always in one Var.
+    return (vars.size() == 1 ? vars[0]->count() : vars.size());
+  }
+  
+  void VarMap::set_rest(const std::vector<std::string>& args) {
+    this->rest_str_ = args;
+    const ArgvView views(this->rest_str_.begin(), this->rest_str_.end());
+    this->set_rest(views, 0);
+  }
+  
+  
+  // ========================================================
+  // argparse::Values
+  //
+  const std::vector<argparse_internal::Var*>&
+  Values::get_var_arr(const std::string& key) const {
+    const VarMap& varmap = *(this->varmap_.get());
+    auto it = (this->prefix_.empty() ? varmap.find(key) :
+               varmap.find(this->prefix_ + key));
+    if (it == varmap.end()) {
+      throw argparse::exception::KeyError(key, "not found in options");
+    }
+    
+    return *(it->second);
+  }
+  
+  const argparse_internal::Var& Values::get_var(const std::string& key,
+                                                size_t idx) const {
+    const auto& arr = this->get_var_arr(key);
+    if (arr.size() <= idx) {
+      throw argparse::exception::IndexError(key);
+    }
+    
+    return *(arr[idx]);
+  }
+  
+  const argparse_internal::Var& Values::get_var(const std::string& key,
+                                                size_t idx,
+                                                size_t *pos) const {
+    const auto& arr = this->get_var_arr(key);
+    // One Var may hold all values, e.g. VarAnyArray, and answers for idx 0
+    // even if empty, e.g. get<std::vector<T>>().
+    if (arr.size() == 1 && (idx == 0 || idx < arr[0]->count())) {
+      *pos = idx;
+      return *(arr[0]);
+    }
+    *pos = 0;
+    return this->get_var(key, idx);
+  }
+  
+  
+  Values::Values(std::shared_ptr<VarMap> varmap) : varmap_(varmap) {
+  }
+  
+  Values::Values(const Values& obj)
+  : varmap_(obj.varmap_), prefix_(obj.prefix_) {
+  }
+  
+  Values::~Values() {
+  }
+  
+  Values& Values::operator=(const Values &obj) {
+    this->varmap_ = obj.varmap_;
+    this->prefix_ = obj.prefix_;
+    return *this;
+  }
+  
+  const std::string& Values::operator[](const std::string& key) const {
+    return this->to_str(key, 0);
+  }
+  
+  const std::string& Values::get(const std::string& key, size_t idx) const {
+    return this->to_str(key, idx);
+  }
+  
+  const std::string& Values::to_str(const std::string& key, size_t idx) const {
+    size_t pos;
+    const argparse_internal::Var& v = this->get_var(key, idx, &pos);
+    return v.str_at(pos);
+  }
+  
+  int Values::to_int(const std::string& key, size_t idx) const {
+    const argparse_internal::Var& v = this->get_var(key, idx);
+    return v.to_i();
+  }
+  
+  int64_t Values::to_int64(const std::string& key, size_t idx) const {
+    const argparse_internal::Var& v = this->get_var(key, idx);
+    return v.to_i64();
+  }
+  
+  uint64_t Values::to_uint64(const std::string& key, size_t idx) const {
+    const argparse_internal::Var& v = this->get_var(key, idx);
+    return v.to_u64();
+  }
+  
+  double Values::to_double(const std::string& key, size_t idx) const {
+    const argparse_internal::Var& v = this->get_var(key, idx);
+    return v.to_d();
+  }
+  
+  std::chrono::nanoseconds Values::to_duration(const std::string& key,
+                                               size_t idx) const {
+    const argparse_internal::Var& v = this->get_var(key, idx);
+    return std::chrono::nanoseconds(v.to_i64());
+  }
+  
+  std::vector<double> Values::to_doubles(const std::string& key) const {
+    const auto& arr = this->get_var_arr(key);
+    std::vector<double> res(arr.size());
+    for (size_t i = 0; i < arr.size(); i++) {
+      res[i] = arr[i]->to_d();
+    }
+    return res;
+  }
+  
+  Int64Span Values::to_int64s(const std::string& key) const {
+    const auto& arr = this->get_var_arr(key);
+    const auto *packed = (arr.size() == 1 ?
+                          dynamic_cast<const argparse_internal::VarIntArray*>(
+                            arr[0]) : nullptr);
+    if (packed == nullptr) {
+      throw exception::TypeError("not packed values: " + key);
+    }
+    return Int64Span(packed->values().data(), packed->values().size());
+  }
+  
+  const SplitList& Values::to_list(const std::string& key) const {
+    return this->get<SplitList>(key, 0);
+  }
+  
+  const KeyValueMap& Values::get_map(const std::string& key) const {
+    return this->get<KeyValueMap>(key, 0);
+  }
+  
+  const IntRanges& Values::to_ranges(const std::string& key, size_t idx) const {
+    return this->get<IntRanges>(key, idx);
+  }
+  
+  const IPAddress& Values::to_ip(const std::string& key, size_t idx) const {
+    return this->get<IPAddress>(key, idx);
+  }
+  
+  std::vector<IPAddress> Values::to_ips(const std::string& key) const {
+    const auto& arr = this->get_var_arr(key);
+    std::vector<IPAddress> res(arr.size());
+    for (size_t i = 0; i < arr.size(); i++) {
+      res[i] = *static_cast<const IPAddress*>(arr[i]->get(typeid(IPAddress)));
+    }
+    return res;
+  }
+  
+  const CidrTable& Values::to_cidrs(const std::string& key) const {
+    return this->get<CidrTable>(key, 0);
+  }
+  
+  ByteSpan Values::to_bytes(const std::string& key, size_t idx) const {
+    const auto& bytes = this->get<std::vector<uint8_t>>(key, idx);
+    return ByteSpan(bytes.data(), bytes.size());
+  }
+  
+  size_t Values::to_index(const std::string& key, size_t idx) const {
+    size_t pos;
+    const argparse_internal::Var& v = this->get_var(key, idx, &pos);
+    return v.index_at(pos);
+  }
+  
+  const void* Values::get_ptr(const std::string& key, size_t idx,
+                              const std::type_info& type) const {
+    size_t pos;
+    const argparse_internal::Var& v = this->get_var(key, idx, &pos);
+    return v.get_at(type, pos);
+  }
+  
+  size_t Values::size(const std::string &key) const {
+    try {
+      const auto& arr = this->get_var_arr(key);
+      return VarMap::count_values(arr);
+    } catch (exception::KeyError &e) {
+      return 0;
+    }
+  }
+  
+  bool Values::is_true(const std::string &key) const {
+    const auto& arr = this->get_var_arr(key);
+    assert(arr.size() == 1);
+    return arr[0]->is_true();
+  }
+  
+  bool Values::is_set(const std::string& dest) const {
+    const VarMap& varmap = *(this->varmap_.get());
+    auto it = (this->prefix_.empty() ? varmap.find(dest) :
+               varmap.find(this->prefix_ + dest));
+    return (it != varmap.end());
+  }
+  
+  Values Values::subtree(const std::string& prefix) const {
+    Values sub(*this);
+    sub.prefix_ += prefix + ".";
+    return sub;
+  }
+  
+  std::vector<std::string> Values::keys() const {
+    // Dests under the prefix are contiguous in the sorted VarMap.
+    const VarMap& varmap = *(this->varmap_.get());
+    std::vector<std::string> res;
+    for (auto it = varmap.lower_bound(this->prefix_);
+         it != varmap.end() &&
+           it->first.compare(0, this->prefix_.length(), this->prefix_) == 0;
+         ++it) {
+      res.push_back(it->first.substr(this->prefix_.length()));
+    }
+    return res;
+  }
+
+  bool Values::is_help_mode() const {
+    return this->varmap_->is_help_mode();
+  }
+
+  bool Values::is_complete_mode() const {
+    return this->varmap_->is_complete_mode();
+  }
+  
+  const ArgvSpan& Values::rest() const {
+    return this->varmap_->rest();
+  }
+  
+  
+  uint64_t KeyValueMap::hash(const StrView& key) {
+    // FNV-1a
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < key.size(); i++) {
+      h = (h ^ static_cast<unsigned char>(key.data()[i])) * 1099511628211ULL;
+    }
+    return h;
+  }
+  
+  size_t KeyValueMap::probe(const StrView& key, uint64_t h) const {
+    const size_t mask = this->slots_.size() - 1;
+    for (size_t i = h & mask; ; i = (i + 1) & mask) {
+      const uint32_t s = this->slots_[i];
+      if (s == 0 ||
+          (this->hashes_[s - 1] == h && this->entries_[s - 1].key == key)) {
+        return i;
+      }
+    }
+  }
+  
+  void KeyValueMap::rehash(size_t capacity) {
+    this->slots_.assign(capacity, 0);
+    for (size_t i = 0; i < this->entries_.size(); i++) {
+      const size_t mask = capacity - 1;
+      size_t s = this->hashes_[i] & mask;
+      while (this->slots_[s] != 0) {
+        s = (s + 1) & mask;
+      }
+      this->slots_[s] = static_cast<uint32_t>(i + 1);
+    }
+  }
+  
+  bool KeyValueMap::insert(const StrView& item, DupKey dup, std::string *err) {
+    const char *eq_ptr = static_cast<const char*>(memchr(item.data(), '=',
+                                                         item.size()));
+    if (eq_ptr == nullptr || eq_ptr == item.data()) {
+      *err = "invalid key=value: " + item.str();
+      return false;
+    }
+    const size_t eq = eq_ptr - item.data();
+    
+    // Keep load factor 1/2 or less.
+    if ((this->entries_.size() + 1) * 2 > this->slots_.size()) {
+      this->rehash(std::max<size_t>(16, this->slots_.size() * 2));
+    }
+    
+    this->raw_.push_back(item.str());
+    const std::string& raw = this->raw_.back();
+    const StrView key(raw.data(), eq);
+    const StrView value(raw.data() + eq + 1, raw.length() - eq - 1);
+    const uint64_t h = KeyValueMap::hash(key);
+    const size_t s = this->probe(key, h);
+    
+    if (this->slots_[s] == 0) {
+      this->slots_[s] = static_cast<uint32_t>(this->entries_.size() + 1);
+      this->entries_.push_back(Entry{key, value});
+      this->hashes_.push_back(h);
+      return true;
+    }
+    
+    // Duplicated key.
+    Entry& entry = this->entries_[this->slots_[s] - 1];
+    switch (dup) {
+      case DupKey::last_wins:
+        entry.key = key;
+        entry.value = value;
+        break;
+      case DupKey::first_wins:
+        this->raw_.pop_back();
+        break;
+      case DupKey::error:
+        *err = "duplicated key: " + key.str();
+        this->raw_.pop_back();
+        return false;
+    }
+    return true;
+  }
+  
+  const KeyValueMap::Entry* KeyValueMap::find(const StrView& key) const {
+    if (this->slots_.empty()) {
+      return nullptr;
+    }
+    const size_t s = this->probe(key, KeyValueMap::hash(key));
+    return (this->slots_[s] == 0 ? nullptr :
+            &this->entries_[this->slots_[s] - 1]);
+  }
+  
+  void SplitList::append(const StrView& val, char delim) {
+    if (! this->buf_.empty()) {
+      this->buf_ += delim;
+    }
+    const size_t base = this->buf_.size();
+    this->buf_.append(val.data(), val.size());
+    
+    // memchr is vectorized by libc.
+    const char *head = this->buf_.data();
+    const char *p = head + base, *end = head + this->buf_.size();
+    while (p < end) {
+      const char *q = static_cast<const char*>(memchr(p, delim, end - p));
+      q = (q ? q : end);
+      if (q > p) {
+        this->items_.push_back(std::make_pair(p - head, q - p));
+      }
+      p = q + 1;
+    }
+  }
+  
+  void SplitList::set_choice(size_t idx) {
+    if (this->choice_bits_.size() <= idx / 64) {
+      this->choice_bits_.resize(idx / 64 + 1, 0);
+    }
+    this->choice_bits_[idx / 64] |= (1ULL << (idx % 64));
+  }
+  
+  // Values of r are also values of range, r.first is in range.
+  static bool range_step_of(const IntRanges::Range& range,
+                            const IntRanges::Range& r) {
+    const uint64_t off = (static_cast<uint64_t>(r.first) -
+                          static_cast<uint64_t>(range.first));
+    return (off % range.step == 0 &&
+            (r.first == r.last || r.step % range.step == 0));
+  }
+  
+  // Cut r to values greater than v or less than v, which is in span of r.
+  // Return false if no value is left.
+  static bool range_from(IntRanges::Range *r, int64_t v) {
+    if (v >= r->last) {
+      return false;
+    }
+    const uint64_t step = static_cast<uint64_t>(r->step);
+    const uint64_t k = ((static_cast<uint64_t>(v) -
+                         static_cast<uint64_t>(r->first)) / step + 1);
+    r->first = static_cast<int64_t>(static_cast<uint64_t>(r->first) +
+                                    k * step);
+    r->step = (r->first == r->last ? 1 : r->step);
+    return true;
+  }
+  
+  static bool range_to(IntRanges::Range *r, int64_t v) {
+    if (v <= r->first) {
+      return false;
+    }
+    const uint64_t step = static_cast<uint64_t>(r->step);
+    const uint64_t k = ((static_cast<uint64_t>(v) - 1 -
+                         static_cast<uint64_t>(r->first)) / step);
+    r->last = static_cast<int64_t>(static_cast<uint64_t>(r->first) +
+                                   k * step);
+    r->step = (r->first == r->last ? 1 : r->step);
+    return true;
+  }
+  
+  // Parse an item "N", "A-B" or "A..B:S" into r, last is set to the last
+  // value and step is 1 for a single value.
+  static bool read_range(const StrView& item, IntRanges::Range *r,
+                         std::string *err) {
+    typedef argparse_internal::Var Var;
+    const char *p = item.data(), *item_end = item.data() + item.size();
+    
+    // Split "A..B:S" or "A-B:S", '-' at head is sign of A.
+    const char *colon = std::find(p, item_end, ':');
+    static const char dots[] = "..";
+    const char *sep = std::search(p, colon, dots, dots + 2);
+    size_t sep_len = 2;
+    if (sep == colon) {
+      sep = (p < colon ? std::find(p + 1, colon, '-') : colon);
+      sep_len = 1;
+    }
+    
+    Var::NumResult res[3] = {Var::NumResult::ok, Var::NumResult::ok,
+                             Var::NumResult::ok};
+    res[0] = Var::parse_int(StrView(p, sep - p), INT64_MIN, INT64_MAX,
+                            &r->first);
+    r->last = r->first;
+    r->step = 1;
+    if (sep != colon) {
+      res[1] = Var::parse_int(StrView(sep + sep_len, colon - sep - sep_len),
+                              INT64_MIN, INT64_MAX, &r->last);
+    }
+    if (colon != item_end) {
+      res[2] = Var::parse_int(StrView(colon + 1, item_end - colon - 1),
+                              INT64_MIN, INT64_MAX, &r->step);
+      if (sep == colon) {
+        res[2] = Var::NumResult::invalid;  // step without range
+      }
+    }
+    
+    for (auto x : res) {
+      if (x == Var::NumResult::out_of_range) {
+        *err = "Out of range for int64: " + item.str();
+        return false;
+      } else if (x != Var::NumResult::ok) {
+        *err = "Invalid range format: " + item.str();
+        return false;
+      }
+    }
+    if (r->last < r->first) {
+      *err = "Invalid range, end is less than start: " + item.str();
+      return false;
+    } else if (r->step < 1) {
+      *err = "Invalid range, step must be positive: " + item.str();
+      return false;
+    }
+    
+    r->last = r->first + static_cast<int64_t>(
+      (static_cast<uint64_t>(r->last) - static_cast<uint64_t>(r->first)) /
+      r->step * r->step);
+    if (r->first == r->last) {
+      r->step = 1;
+    }
+    return true;
+  }
+  
+  bool IntRanges::check(const StrView& val, int64_t *lo, int64_t *hi) {
+    // Only two stepped ranges can conflict, then they are merged by parse()
+    // in the rare case.
+    size_t stepped = 0;
+    *lo = INT64_MAX;
+    *hi = INT64_MIN;
+    std::string err;
+    const char *p = val.data(), *end = val.data() + val.size();
+    while (true) {
+      const char *item_end = std::find(p, end, ',');
+      Range r;
+      if (! read_range(StrView(p, item_end - p), &r, &err)) {
+        return false;
+      }
+      stepped += (r.step > 1 ? 1 : 0);
+      *lo = std::min(*lo, r.first);
+      *hi = std::max(*hi, r.last);
+      if (item_end == end) {
+        break;
+      }
+      p = item_end + 1;
+    }
+    
+    IntRanges ranges;
+    return (stepped < 2 || ranges.parse(val, &err));
+  }
+  
+  bool IntRanges::parse(const StrView& val, std::string *err) {
+    std::vector<Range> ranges;
+    const char *p = val.data(), *end = val.data() + val.size();
+    while (true) {
+      const char *item_end = std::find(p, end, ',');
+      Range r;
+      if (! read_range(StrView(p, item_end - p), &r, err)) {
+        return false;
+      }
+      ranges.push_back(r);
+      if (item_end == end) {
+        break;
+      }
+      p = item_end + 1;
+    }
+    
+    // Merge overlapping and adjacent ranges of step 1. A stepped range is
+    // split around a range of step 1 in its span, e.g. "1..10:2,4" is
+    // "1..3:2,4,5..9:2". Only stepped ranges overlapping each other with
+    // different values are an error.
+    auto less = [](const Range& a, const Range& b) {
+      return (a.first < b.first || (a.first == b.first && a.last > b.last));
+    };
+    std::sort(ranges.begin(), ranges.end(), less);
+    this->ranges_.clear();
+    for (size_t i = 0; i < ranges.size(); i++) {
+      const Range r = ranges[i];
+      if (this->ranges_.empty()) {
+        this->ranges_.push_back(r);
+        continue;
+      }
+      
+      Range& back = this->ranges_.back();
+      const bool adjacent = (back.step == 1 && r.step == 1 &&
+                             back.last != INT64_MAX &&
+                             r.first == back.last + 1);
+      Range rest;
+      if (r.first > back.last && ! adjacent) {
+        this->ranges_.push_back(r);
+      } else if (back.step == 1 && r.step == 1) {
+        back.last = std::max(back.last, r.last);
+      } else if (r.last <= back.last && range_step_of(back, r)) {
+        // All values of r are in back.
+      } else if (back.step == 1) {
+        // Values of stepped r after back.
+        rest = r;
+        if (range_from(&rest, back.last)) {
+          ranges.insert(std::upper_bound(ranges.begin() + i + 1,
+                                         ranges.end(), rest, less), rest);
+        }
+      } else if (r.step == 1) {
+        // Values of back after r are put back in order, and r is tried
+        // again after back is cut before r.
+        rest = back;
+        if (range_from(&rest, r.last)) {
+          ranges.insert(std::upper_bound(ranges.begin() + i + 1,
+                                         ranges.end(), rest, less), rest);
+        }
+        if (! range_to(&back, r.first)) {
+          this->ranges_.pop_back();
+        }
+        i--;
+      } else {
+        *err = "Overlapping ranges with step: " + val.str();
+        return false;
+      }
+    }
+    
+    return true;
+  }
+  
+  bool IntRanges::contains(int64_t v) const {
+    // The last range starting at v or before.
+    auto it = std::upper_bound(this->ranges_.begin(), this->ranges_.end(), v,
+                               [](int64_t x, const Range& r) {
+                                 return x < r.first;
+                               });
+    if (it == this->ranges_.begin()) {
+      return false;
+    }
+    --it;
+    return (v <= it->last &&
+            (static_cast<uint64_t>(v) - static_cast<uint64_t>(it->first)) %
+            it->step == 0);
+  }
+  
+  static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') {
+      return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      return c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      return c - 'A' + 10;
+    }
+    return -1;
+  }
+  
+  // Read dotted decimal into 4 bytes of out.
+  static bool read_v4(const char *p, const char *end, uint8_t *out) {
+    for (int i = 0; i < 4; i++) {
+      const char *s = p;
+      unsigned v = 0;
+      while (p < end && *p >= '0' && *p <= '9' && p - s < 3) {
+        v = v * 10 + (*p - '0');
+        p++;
+      }
+      // Leading zero is not allowed not to be confused with octal.
+      if (p == s || v > 255 || (*s == '0' && p - s > 1)) {
+        return false;
+      }
+      out[i] = static_cast<uint8_t>(v);
+      if (i < 3) {
+        if (p == end || *p != '.') {
+          return false;
+        }
+        p++;
+      }
+    }
+    return p == end;
+  }
+  
+  bool IPAddress::is_v4() const {
+    static const uint8_t mapped[12] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                       0xff, 0xff};
+    return memcmp(this->bytes, mapped, sizeof(mapped)) == 0;
+  }
+  
+  uint32_t IPAddress::v4() const {
+    if (! this->is_v4()) {
       return 0;
     }
+    return ((static_cast<uint32_t>(this->bytes[12]) << 24) |
+            (static_cast<uint32_t>(this->bytes[13]) << 16) |
+            (static_cast<uint32_t>(this->bytes[14]) << 8) |
+            static_cast<uint32_t>(this->bytes[15]));
+  }
+  
+  bool IPAddress::parse_v4(const StrView& val, IPAddress *out) {
+    IPAddress addr;
+    memset(addr.bytes, 0, 10);
+    addr.bytes[10] = addr.bytes[11] = 0xff;
+    if (! read_v4(val.data(), val.data() + val.size(), addr.bytes + 12)) {
+      return false;
+    }
+    *out = addr;
+    return true;
+  }
+  
+  bool IPAddress::parse_v6(const StrView& val, IPAddress *out) {
+    const char *p = val.data(), *end = val.data() + val.size();
+    uint8_t buf[16];
+    size_t n = 0;   // bytes read
+    int gap = -1;   // position of "::"
+    
+    if (end - p >= 2 && p[0] == ':' && p[1] == ':') {
+      gap = 0;
+      p += 2;
+    }
+    while (p < end) {
+      // IPv4 at tail, e.g. "::ffff:10.0.0.1".
+      const char *colon = static_cast<const char*>(memchr(p, ':', end - p));
+      if (memchr(p, '.', (colon ? colon : end) - p) != nullptr) {
+        if (n > 12 || ! read_v4(p, end, buf + n)) {
+          return false;
+        }
+        n += 4;
+        p = end;
+        break;
+      }
+      
+      unsigned v = 0;
+      const char *s = p;
+      int d;
+      while (p < end && p - s < 4 && (d = hex_digit(*p)) >= 0) {
+        v = (v << 4) | d;
+        p++;
+      }
+      if (p == s || n == 16) {
+        return false;
+      }
+      buf[n++] = static_cast<uint8_t>(v >> 8);
+      buf[n++] = static_cast<uint8_t>(v);
+      
+      if (p == end) {
+        break;
+      } else if (*p != ':' || ++p == end) {
+        return false;
+      } else if (*p == ':') {
+        if (gap >= 0) {
+          return false;
+        }
+        gap = static_cast<int>(n);
+        p++;
+      }
+    }
+    
+    if (gap < 0) {
+      if (n != 16) {
+        return false;
+      }
+      memcpy(out->bytes, buf, 16);
+    } else {
+      if (n > 14) {
+        return false;
+      }
+      const size_t tail = n - gap;
+      memset(out->bytes, 0, 16);
+      memcpy(out->bytes, buf, gap);
+      memcpy(out->bytes + 16 - tail, buf + gap, tail);
+    }
+    return true;
+  }
+  
+  bool IPAddress::parse(const StrView& val, IPAddress *out) {
+    return (IPAddress::parse_v4(val, out) || IPAddress::parse_v6(val, out));
+  }
+  
+  bool MacAddr::parse(const StrView& val, MacAddr *out) {
+    if (val.size() != 17 || (val[2] != ':' && val[2] != '-')) {
+      return false;
+    }
+    const char sep = val[2];
+    MacAddr mac;
+    for (size_t i = 0; i < 6; i++) {
+      const int hi = hex_digit(val[i * 3]), lo = hex_digit(val[i * 3 + 1]);
+      if (hi < 0 || lo < 0 || (i < 5 && val[i * 3 + 2] != sep)) {
+        return false;
+      }
+      mac.bytes[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    *out = mac;
+    return true;
+  }
+  
+  // Increment as 128 bit integer, return false if it overflows.
+  static bool next_addr(IPAddress *addr) {
+    for (int i = 15; i >= 0; i--) {
+      if (++addr->bytes[i] != 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+  
+  // Parse a block "addr/len" of item into c with host bits cleared, and
+  // set the last address of it.
+  static bool read_cidr(const StrView& item, CidrTable::Cidr *c,
+                        IPAddress *last, std::string *err) {
+    const char *p = item.data(), *q = item.data() + item.size();
+    const char *slash = static_cast<const char*>(memchr(p, '/', q - p));
+    const StrView addr(p, (slash ? slash : q) - p);
+    
+    unsigned max_len = 32;
+    if (! IPAddress::parse_v4(addr, &c->addr)) {
+      max_len = 128;
+      if (! IPAddress::parse_v6(addr, &c->addr)) {
+        *err = "Invalid address: " + item.str();
+        return false;
+      }
+    }
+    unsigned len = max_len;
+    if (slash) {
+      const char *s = slash + 1;
+      len = 0;
+      while (s < q && *s >= '0' && *s <= '9' && s - slash <= 3) {
+        len = len * 10 + (*s - '0');
+        s++;
+      }
+      if (s != q || s == slash + 1 || len > max_len) {
+        *err = "Invalid prefix length: " + item.str();
+        return false;
+      }
+    }
+    c->length = static_cast<uint8_t>(len);
+    
+    // Clear and set host bits in 128 bit space for first and last.
+    const unsigned bits = len + (128 - max_len);
+    *last = c->addr;
+    for (unsigned i = 0; i < 16; i++) {
+      if (i * 8 >= bits) {
+        c->addr.bytes[i] = 0;
+        last->bytes[i] = 0xff;
+      } else if (i * 8 + 8 > bits) {
+        c->addr.bytes[i] &= static_cast<uint8_t>(0xff << (i * 8 + 8 - bits));
+        last->bytes[i] |= static_cast<uint8_t>(0xff >> (bits - i * 8));
+      }
+    }
+    return true;
+  }
+  
+  bool CidrTable::check(const StrView& val, std::string *err) {
+    const char *p = val.data(), *end = val.data() + val.size();
+    while (true) {
+      const char *q = static_cast<const char*>(memchr(p, ',', end - p));
+      q = (q ? q : end);
+      Cidr c;
+      IPAddress last;
+      if (! read_cidr(StrView(p, q - p), &c, &last, err)) {
+        return false;
+      }
+      if (q == end) {
+        return true;
+      }
+      p = q + 1;
+    }
+  }
+  
+  bool CidrTable::add(const StrView& val, std::string *err) {
+    const char *p = val.data(), *end = val.data() + val.size();
+    const size_t first = this->cidrs_.size();
+    const size_t table_first = this->table_.size();
+    while (true) {
+      const char *q = static_cast<const char*>(memchr(p, ',', end - p));
+      q = (q ? q : end);
+      Cidr c;
+      IPAddress last;
+      if (! read_cidr(StrView(p, q - p), &c, &last, err)) {
+        this->cidrs_.resize(first);
+        this->table_.resize(table_first);
+        return false;
+      }
+      this->cidrs_.push_back(c);
+      this->table_.push_back(std::make_pair(c.addr, last));
+      
+      if (q == end) {
+        break;
+      }
+      p = q + 1;
+    }
+    
+    // Merge overlapping and adjacent intervals.
+    std::sort(this->table_.begin(), this->table_.end());
+    size_t n = 0;
+    for (size_t k = 0; k < this->table_.size(); k++) {
+      const auto& r = this->table_[k];
+      if (n > 0) {
+        auto& back = this->table_[n - 1];
+        IPAddress next = back.second;
+        if (! (back.second < r.first) ||
+            (next_addr(&next) && next == r.first)) {
+          if (back.second < r.second) {
+            back.second = r.second;
+          }
+          continue;
+        }
+      }
+      this->table_[n++] = r;
+    }
+    this->table_.resize(n);
+    return true;
+  }
+  
+  bool CidrTable::contains(const IPAddress& addr) const {
+    // The last interval starting at addr or before.
+    auto it = std::upper_bound(
+      this->table_.begin(), this->table_.end(), addr,
+      [](const IPAddress& a, const std::pair<IPAddress, IPAddress>& r) {
+        return a < r.first;
+      });
+    if (it == this->table_.begin()) {
+      return false;
+    }
+    --it;
+    return ! (it->second < addr);
+  }
+
+}
+
+
+
+// ==================================================================
+// Internal Classes
+//
+
+namespace argparse_internal {
+  
+  Var* Var::build_var(const argparse::StrView& val, argparse::ArgType type) {
+    Var *opt = NULL;
+    
+    switch (type) {
+      case argparse::ArgType::INT:
+      case argparse::ArgType::INT32:
+        opt = new VarInt(val);
+        break;
+        
+      case argparse::ArgType::STR:
+        opt = new VarStr(val.str());
+        break;
+
+      case argparse::ArgType::BOOL:
+        opt = new VarBool(val);
+        break;
+        
+      case argparse::ArgType::INT64:
+        opt = new VarInt64(val);
+        break;
+        
+      case argparse::ArgType::UINT64:
+      case argparse::ArgType::SIZE:
+      case argparse::ArgType::DURATION:
+        opt = new VarUint64(val, type);
+        break;
+        
+      case argparse::ArgType::DOUBLE:
+        opt = new VarDouble(val);
+        break;
+        
+      case argparse::ArgType::FLOAT:
+        opt = new VarFloat(val);
+        break;
+        
+      case argparse::ArgType::INT_RANGES:
+      case argparse::ArgType::PORTS:
+        opt = new VarIntRanges(val, type);
+        break;
+        
+      case argparse::ArgType::IP:
+      case argparse::ArgType::IPV4:
+      case argparse::ArgType::IPV6:
+        opt = new VarIP(val, type);
+        break;
+        
+      case argparse::ArgType::CIDR:
+        opt = new VarCidr(val);
+        break;
+        
+      case argparse::ArgType::MAC:
+        opt = new VarMac(val);
+        break;
+        
+      case argparse::ArgType::HEX:
+      case argparse::ArgType::BASE64:
+        opt = new VarBytes(val, type);
+        break;
+    }
+    
+    assert(opt);
+    
+    if (! opt->is_valid()) {
+      const std::string msg = opt->err();
+      delete opt;
+      throw argparse::exception::ParseError(msg);
+    }
+
+    return opt;
+  }
+  
+  
+  bool Var::check(const argparse::StrView& val, argparse::ArgType type) {
+    int64_t i, hi;
+    uint64_t u;
+    double d;
+    argparse::IPAddress addr;
+    std::string err;
+    
+    switch (type) {
+      case argparse::ArgType::INT:
+      case argparse::ArgType::INT32:
+        return (Var::parse_int(val, INT32_MIN, INT32_MAX, &i) ==
+                NumResult::ok);
+        
+      case argparse::ArgType::INT64:
+        return (Var::parse_int(val, INT64_MIN, INT64_MAX, &i) ==
+                NumResult::ok);
+        
+      case argparse::ArgType::UINT64:
+        return (Var::parse_uint(val, UINT64_MAX, &u) == NumResult::ok);
+        
+      case argparse::ArgType::SIZE:
+        return (Var::parse_size(val, &u) == NumResult::ok);
+        
+      case argparse::ArgType::DURATION:
+        return (Var::parse_duration(val, &u) == NumResult::ok);
+        
+      case argparse::ArgType::INT_RANGES:
+        return argparse::IntRanges::check(val, &i, &hi);
+        
+      case argparse::ArgType::PORTS:
+        return (argparse::IntRanges::check(val, &i, &hi) && i >= 0 &&
+                hi <= 65535);
+        
+      case argparse::ArgType::IP:
+        return argparse::IPAddress::parse(val, &addr);
+        
+      case argparse::ArgType::IPV4:
+        return argparse::IPAddress::parse_v4(val, &addr);
+        
+      case argparse::ArgType::IPV6:
+        return argparse::IPAddress::parse_v6(val, &addr);
+        
+      case argparse::ArgType::CIDR:
+        return argparse::CidrTable::check(val, &err);
+        
+      case argparse::ArgType::MAC: {
+        argparse::MacAddr mac;
+        return argparse::MacAddr::parse(val, &mac);
+      }
+        
+      case argparse::ArgType::HEX:
+        return Var::check_hex(val);
+        
+      case argparse::ArgType::BASE64:
+        return Var::check_base64(val);
+        
+      case argparse::ArgType::DOUBLE:
+      case argparse::ArgType::FLOAT:
+        return (Var::parse_double(val, type == argparse::ArgType::FLOAT, &d)
+                == NumResult::ok);
+        
+      case argparse::ArgType::STR:
+        return true;
+        
+      case argparse::ArgType::BOOL:
+        return (val == "true" || val == "false");
+    }
+    
+    return false;
+  }
+  
+  // SWAR check and conversion of 8 ASCII digits loaded in little endian.
+  static inline bool is_eight_digits(uint64_t v) {
+    return (((v & 0xF0F0F0F0F0F0F0F0ULL) |
+             (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+            0x3333333333333333ULL);
+  }
+  
+  static inline uint64_t eight_digits(uint64_t v) {
+    v = ((v & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+    v = ((v & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+    return ((v & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32;
+  }
+  
+  // Parse 1 to 16 decimal digits by 8 digits at once. The first chunk is
+  // padded with '0' at left.
+  static bool swar_decimal(const char *p, const char *end, uint64_t *out) {
+    const size_t len = end - p;
+    size_t n = (len > 8 ? len - 8 : len);
+    uint64_t v = 0;
+    while (p < end) {
+      char buf[8];
+      memset(buf, '0', sizeof(buf));
+      memcpy(buf + sizeof(buf) - n, p, n);
+      uint64_t w;
+      memcpy(&w, buf, sizeof(w));
+      if (! is_eight_digits(w)) {
+        return false;
+      }
+      v = v * 100000000 + eight_digits(w);
+      p += n;
+      n = 8;
+    }
+    *out = v;
+    return true;
+  }
+  
+  // Parse digits after sign, then overflow of uint64_t is out_of_range.
+  static Var::NumResult parse_digits(const char *p, const char *end,
+                                     uint64_t *out) {
+    unsigned base = 10;
+    if (end - p >= 2 && p[0] == '0') {
+      switch (p[1]) {
+        case 'x': case 'X': base = 16; p += 2; break;
+        case 'o': case 'O': base = 8;  p += 2; break;
+        case 'b': case 'B': base = 2;  p += 2; break;
+        default:            base = 8;  p += 1; break;  // as strtol
+      }
+    }
+    
+    if (p == end) {
+      return Var::NumResult::invalid;
+    }
+    
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (base == 10 && end - p <= 16) {
+      return (swar_decimal(p, end, out) ?
+              Var::NumResult::ok : Var::NumResult::invalid);
+    }
+#endif
+    
+    uint64_t v = 0;
+    bool overflow = false;
+    for (; p < end; p++) {
+      unsigned d;
+      if (*p >= '0' && *p <= '9') {
+        d = *p - '0';
+      } else if (*p >= 'a' && *p <= 'f') {
+        d = *p - 'a' + 10;
+      } else if (*p >= 'A' && *p <= 'F') {
+        d = *p - 'A' + 10;
+      } else {
+        return Var::NumResult::invalid;
+      }
+      
+      if (d >= base) {
+        return Var::NumResult::invalid;
+      }
+      // Keep checking format after overflow.
+      overflow = overflow || (v > (UINT64_MAX - d) / base);
+      v = v * base + d;
+    }
+    
+    *out = v;
+    return (overflow ? Var::NumResult::out_of_range : Var::NumResult::ok);
+  }
+  
+  Var::NumResult Var::parse_int(const argparse::StrView& val, int64_t min,
+                                int64_t max, int64_t *out) {
+    const char *p = val.data(), *end = val.data() + val.size();
+    const bool neg = (p < end && *p == '-');
+    if (p < end && (*p == '-' || *p == '+')) {
+      p++;
+    }
+    
+    uint64_t m;
+    NumResult r = parse_digits(p, end, &m);
+    if (r != NumResult::ok) {
+      return r;
+    }
+    
+    if (neg) {
+      // -(min) as uint64_t without overflow of int64_t.
+      const uint64_t lim = static_cast<uint64_t>(-(min + 1)) + 1;
+      if (min >= 0 || m > lim) {
+        return (m == 0 ? (*out = 0, NumResult::ok) : NumResult::out_of_range);
+      }
+      *out = (m == lim ? min : -static_cast<int64_t>(m));
+    } else {
+      if (m > static_cast<uint64_t>(max)) {
+        return NumResult::out_of_range;
+      }
+      *out = static_cast<int64_t>(m);
+    }
+    return NumResult::ok;
+  }
+  
+  Var::NumResult Var::parse_uint(const argparse::StrView& val, uint64_t max,
+                                 uint64_t *out) {
+    const char *p = val.data(), *end = val.data() + val.size();
+    const bool neg = (p < end && *p == '-');
+    if (p < end && (*p == '-' || *p == '+')) {
+      p++;
+    }
+    
+    NumResult r = parse_digits(p, end, out);
+    if (r == NumResult::ok && (*out > max || (neg && *out != 0))) {
+      return NumResult::out_of_range;
+    }
+    return r;
+  }
+  
+  // Error message of parse_int, parse_uint and parse_double.
+  static std::string num_error(Var::NumResult r, const argparse::StrView& val,
+                               const char *type) {
+    if (r == Var::NumResult::out_of_range) {
+      return "Out of range for " + std::string(type) + ": " + val.str();
+    }
+    return "Invalid number format: " + val.str();
+  }
+  
+  VarInt::VarInt(const argparse::StrView& val) : value_(0), str_(val.str()) {
+    int64_t v;
+    NumResult r = Var::parse_int(val, INT32_MIN, INT32_MAX, &v);
+    if (r != NumResult::ok) {
+      this->set_err(num_error(r, val, "int"));
+    } else {
+      this->value_ = static_cast<int>(v);
+    }
+  }
+  
+  VarInt64::VarInt64(const argparse::StrView& val)
+  : value_(0), str_(val.str()) {
+    NumResult r = Var::parse_int(val, INT64_MIN, INT64_MAX, &this->value_);
+    if (r != NumResult::ok) {
+      this->set_err(num_error(r, val, "int64"));
+    }
+  }
+  
+  int VarInt64::to_i() const {
+    if (this->value_ < INT_MIN || this->value_ > INT_MAX) {
+      throw argparse::exception::TypeError("out of range for int: " +
+                                           this->str_);
+    }
+    return static_cast<int>(this->value_);
+  }
+  
+  VarUint64::VarUint64(const argparse::StrView& val, argparse::ArgType type)
+  : value_(0), str_(val.str()) {
+    NumResult r;
+    const char *name;
+    if (type == argparse::ArgType::SIZE) {
+      r = Var::parse_size(val, &this->value_);
+      name = "size";
+    } else if (type == argparse::ArgType::DURATION) {
+      r = Var::parse_duration(val, &this->value_);
+      name = "duration";
+    } else {
+      r = Var::parse_uint(val, UINT64_MAX, &this->value_);
+      name = "uint64";
+    }
+    if (r != NumResult::ok) {
+      this->set_err(num_error(r, val, name));
+    }
+  }
+  
+  int VarUint64::to_i() const {
+    if (this->value_ > INT_MAX) {
+      throw argparse::exception::TypeError("out of range for int: " +
+                                           this->str_);
+    }
+    return static_cast<int>(this->value_);
+  }
+  
+  int64_t VarUint64::to_i64() const {
+    if (this->value_ > INT64_MAX) {
+      throw argparse::exception::TypeError("out of range for int64: " +
+                                           this->str_);
+    }
+    return static_cast<int64_t>(this->value_);
+  }
+  
+  // Read digits with optional fraction such as "12.5" from *p, and return
+  // the integer part and range of fraction digits.
+  static Var::NumResult read_decimal(const char **p, const char *end,
+                                     uint64_t *ip, const char **frac,
+                                     const char **frac_end) {
+    const char *q = *p;
+    bool overflow = false;
+    *ip = 0;
+    for (; q < end && isdigit(static_cast<unsigned char>(*q)); q++) {
+      overflow = overflow || (*ip > (UINT64_MAX - (*q - '0')) / 10);
+      *ip = *ip * 10 + (*q - '0');
+    }
+    const bool has_int = (q != *p);
+    
+    *frac = *frac_end = q;
+    if (q < end && *q == '.') {
+      *frac = ++q;
+      for (; q < end && isdigit(static_cast<unsigned char>(*q)); q++) {}
+      *frac_end = q;
+    }
+    
+    if (! has_int && *frac == *frac_end) {
+      return Var::NumResult::invalid;
+    }
+    *p = q;
+    return (overflow ? Var::NumResult::out_of_range : Var::NumResult::ok);
+  }
+  
+  // ip.frac * mult rounded down. The fraction is multiplied from the last
+  // digit, then no precision is lost and each step is in range.
+  static Var::NumResult scale_decimal(uint64_t ip, const char *frac,
+                                      const char *frac_end, uint64_t mult,
+                                      uint64_t *out) {
+    if (ip > UINT64_MAX / mult) {
+      return Var::NumResult::out_of_range;
+    }
+    uint64_t f = 0;
+    for (const char *q = frac_end; q > frac; q--) {
+      f = ((q[-1] - '0') * mult + f) / 10;
+    }
+    if (ip * mult > UINT64_MAX - f) {
+      return Var::NumResult::out_of_range;
+    }
+    *out = ip * mult + f;
+    return Var::NumResult::ok;
+  }
+  
+  // Case insensitive comparison with lower case word.
+  static bool equal_word(const char *p, const char *end, const char *word) {
+    for (; p < end && *word; p++, word++) {
+      if (tolower(static_cast<unsigned char>(*p)) != *word) {
+        return false;
+      }
+    }
+    return (p == end && *word == '\0');
+  }
+  
+  Var::NumResult Var::parse_size(const argparse::StrView& val, uint64_t *out) {
+    const char *p = val.data(), *end = val.data() + val.size();
+    uint64_t ip;
+    const char *frac, *frac_end;
+    NumResult r = read_decimal(&p, end, &ip, &frac, &frac_end);
+    if (r != NumResult::ok) {
+      return r;
+    }
+    
+    // Units are case insensitive, e.g. "4k", "4kb" and "4kib".
+    uint64_t mult = 1;
+    static const char units[] = "KMGTP";
+    const char *u = (p < end && *p != '\0' ?
+                     strchr(units, toupper(static_cast<unsigned char>(*p))) :
+                     nullptr);
+    if (u) {
+      const size_t exp = u - units + 1;
+      p++;
+      uint64_t base = 1024;
+      if (equal_word(p, end, "b")) {
+        base = 1000;
+        p++;
+      } else if (equal_word(p, end, "ib")) {
+        p += 2;
+      }
+      for (size_t i = 0; i < exp; i++) {
+        mult *= base;
+      }
+    } else if (equal_word(p, end, "b")) {
+      p++;
+    }
+    
+    if (p != end) {
+      return NumResult::invalid;
+    }
+    return scale_decimal(ip, frac, frac_end, mult, out);
+  }
+  
+  Var::NumResult Var::parse_duration(const argparse::StrView& val,
+                                     uint64_t *out) {
+    if (val == "0") {
+      *out = 0;
+      return NumResult::ok;
+    }
+    
+    static const struct {
+      const char *name;
+      uint64_t nsec;
+    } units[] = {
+      // Longer names first to match "ms" before "m".
+      {"ns", 1ULL},
+      {"us", 1000ULL},
+      {"\xC2\xB5s", 1000ULL},  // micro sign
+      {"ms", 1000000ULL},
+      {"s",  1000000000ULL},
+      {"m",  60000000000ULL},
+      {"h",  3600000000000ULL},
+      {"d",  86400000000000ULL},
+    };
+    
+    const char *p = val.data(), *end = val.data() + val.size();
+    if (p == end) {
+      return NumResult::invalid;
+    }
+    
+    uint64_t total = 0;
+    bool overflow = false;
+    while (p < end) {
+      uint64_t ip;
+      const char *frac, *frac_end;
+      NumResult r = read_decimal(&p, end, &ip, &frac, &frac_end);
+      if (r == NumResult::invalid) {
+        return r;
+      }
+      overflow = overflow || (r == NumResult::out_of_range);
+      
+      uint64_t mult = 0;
+      for (const auto& u : units) {
+        const size_t len = strlen(u.name);
+        if (static_cast<size_t>(end - p) >= len &&
+            memcmp(p, u.name, len) == 0) {
+          mult = u.nsec;
+          p += len;
+          break;
+        }
+      }
+      if (mult == 0) {
+        return NumResult::invalid;
+      }
+      
+      uint64_t v = 0;
+      if (! overflow &&
+          (scale_decimal(ip, frac, frac_end, mult, &v) != NumResult::ok ||
+           total > UINT64_MAX - v)) {
+        overflow = true;
+      }
+      total += v;
+    }
+    
+    *out = total;
+    return (overflow ? NumResult::out_of_range : NumResult::ok);
+  }
+  
+  bool Var::is_nonfinite(const argparse::StrView& val) {
+    const char *p = val.data(), *end = val.data() + val.size();
+    if (p < end && (*p == '-' || *p == '+')) {
+      p++;
+    }
+    return (equal_word(p, end, "inf") || equal_word(p, end, "infinity") ||
+            equal_word(p, end, "nan"));
+  }
+  
+  Var::NumResult Var::parse_double(const argparse::StrView& val, bool single,
+                                   double *out) {
+    const char *p = val.data(), *end = val.data() + val.size();
+    const bool neg = (p < end && *p == '-');
+    if (p < end && (*p == '-' || *p == '+')) {
+      p++;
+    }
+    
+    if (equal_word(p, end, "inf") || equal_word(p, end, "infinity")) {
+      *out = (neg ? -HUGE_VAL : HUGE_VAL);
+      return NumResult::ok;
+    } else if (equal_word(p, end, "nan")) {
+      *out = NAN;
+      return NumResult::ok;
+    }
+    
+    // Read up to 19 significant digits into mantissa and scale by exp10.
+    uint64_t mantissa = 0;
+    int sig = 0, exp10 = 0;
+    bool exact = true, has_digit = false;
+    for (; p < end && isdigit(static_cast<unsigned char>(*p)); p++) {
+      has_digit = true;
+      if (sig < 19) {
+        mantissa = mantissa * 10 + (*p - '0');
+        sig += (mantissa > 0);
+      } else {
+        exact = exact && (*p == '0');
+        exp10++;
+      }
+    }
+    if (p < end && *p == '.') {
+      for (p++; p < end && isdigit(static_cast<unsigned char>(*p)); p++) {
+        has_digit = true;
+        if (sig < 19) {
+          mantissa = mantissa * 10 + (*p - '0');
+          sig += (mantissa > 0);
+          exp10--;
+        } else {
+          exact = exact && (*p == '0');
+        }
+      }
+    }
+    if (! has_digit) {
+      return NumResult::invalid;
+    }
+    
+    if (p < end && (*p == 'e' || *p == 'E')) {
+      p++;
+      const bool exp_neg = (p < end && *p == '-');
+      if (p < end && (*p == '-' || *p == '+')) {
+        p++;
+      }
+      if (p == end) {
+        return NumResult::invalid;
+      }
+      int e = 0;
+      for (; p < end && isdigit(static_cast<unsigned char>(*p)); p++) {
+        e = std::min(e * 10 + (*p - '0'), 100000);  // saturate, far over range
+      }
+      exp10 += (exp_neg ? -e : e);
+    }
+    if (p != end) {
+      return NumResult::invalid;
+    }
+    
+    double d;
+    static const double pow10[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+      1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+    static const float pow10f[] = {
+      1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f,
+    };
+    if (mantissa == 0) {
+      d = 0.0;
+    } else if (! single && exact && mantissa <= (1ULL << 53) &&
+               exp10 >= -22 && exp10 <= 22) {
+      // Both of mantissa and 10^|exp10| are exact in double, then one
+      // multiplication or division is correctly rounded (Clinger).
+      d = static_cast<double>(mantissa);
+      d = (exp10 < 0 ? d / pow10[-exp10] : d * pow10[exp10]);
+    } else if (single && exact && mantissa <= (1ULL << 24) &&
+               exp10 >= -10 && exp10 <= 10) {
+      // Same in float, rounding a double again to float is not correct.
+      float f = static_cast<float>(mantissa);
+      f = (exp10 < 0 ? f / pow10f[-exp10] : f * pow10f[exp10]);
+      d = f;
+    } else {
+      // strtod needs null terminated string and val is checked above.
+      char buf[64];
+      std::string tmp;
+      const char *s = buf;
+      if (val.size() < sizeof(buf)) {
+        memcpy(buf, val.data(), val.size());
+        buf[val.size()] = '\0';
+      } else {
+        tmp = val.str();
+        s = tmp.c_str();
+      }
+      // "C" locale not to depend on decimal point of the process locale.
+      static const locale_t c_locale = newlocale(LC_ALL_MASK, "C", 0);
+      d = fabs(single ? strtof_l(s, nullptr, c_locale) :
+               strtod_l(s, nullptr, c_locale));
+    }
+    
+    if (d > (single ? FLT_MAX : DBL_MAX)) {
+      return NumResult::out_of_range;
+    }
+    *out = (neg ? -d : d);
+    return NumResult::ok;
+  }
+  
+  // Lookup tables of hex and base64 digits, 0xff for an invalid char.
+  struct DigitTables {
+    uint8_t hex[256];
+    uint8_t b64[256];
+    
+    DigitTables() {
+      memset(this->hex, 0xff, sizeof(this->hex));
+      memset(this->b64, 0xff, sizeof(this->b64));
+      for (int i = 0; i < 10; i++) {
+        this->hex['0' + i] = static_cast<uint8_t>(i);
+      }
+      for (int i = 0; i < 6; i++) {
+        this->hex['a' + i] = this->hex['A' + i] = static_cast<uint8_t>(10 + i);
+      }
+      static const char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+      for (int i = 0; i < 64; i++) {
+        this->b64[static_cast<unsigned char>(alphabet[i])] =
+          static_cast<uint8_t>(i);
+      }
+    }
+  };
+  static const DigitTables digit_tables;
+  
+  static bool has_hex_prefix(const argparse::StrView& val) {
+    return (val.size() >= 2 && val[0] == '0' &&
+            (val[1] == 'x' || val[1] == 'X'));
+  }
+  
+  bool Var::decode_hex(const argparse::StrView& val,
+                       std::vector<uint8_t> *out) {
+    const size_t skip = (has_hex_prefix(val) ? 2 : 0);
+    const unsigned char *p =
+      reinterpret_cast<const unsigned char*>(val.data()) + skip;
+    const size_t len = val.size() - skip;
+    if (len % 2 != 0 || (skip > 0 && len == 0)) {
+      return false;
+    }
+    
+    const uint8_t *t = digit_tables.hex;
+    out->resize(len / 2);
+    uint8_t *dst = out->data();
+    // Invalid digits are checked once per 8 digits by OR of lookups.
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8, dst += 4) {
+      const uint8_t d0 = t[p[i]], d1 = t[p[i + 1]], d2 = t[p[i + 2]],
+        d3 = t[p[i + 3]], d4 = t[p[i + 4]], d5 = t[p[i + 5]],
+        d6 = t[p[i + 6]], d7 = t[p[i + 7]];
+      if ((d0 | d1 | d2 | d3 | d4 | d5 | d6 | d7) & 0xf0) {
+        return false;
+      }
+      dst[0] = static_cast<uint8_t>((d0 << 4) | d1);
+      dst[1] = static_cast<uint8_t>((d2 << 4) | d3);
+      dst[2] = static_cast<uint8_t>((d4 << 4) | d5);
+      dst[3] = static_cast<uint8_t>((d6 << 4) | d7);
+    }
+    for (; i < len; i += 2) {
+      const uint8_t hi = t[p[i]], lo = t[p[i + 1]];
+      if ((hi | lo) & 0xf0) {
+        return false;
+      }
+      *dst++ = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+  }
+  
+  bool Var::decode_base64(const argparse::StrView& val,
+                          std::vector<uint8_t> *out) {
+    const unsigned char *p =
+      reinterpret_cast<const unsigned char*>(val.data());
+    const size_t len = val.size();
+    if (len % 4 != 0) {
+      return false;
+    }
+    const size_t pad = (len == 0 ? 0 :
+                        p[len - 1] != '=' ? 0 : p[len - 2] != '=' ? 1 : 2);
+    
+    const uint8_t *t = digit_tables.b64;
+    out->resize(len / 4 * 3 - pad);
+    uint8_t *dst = out->data();
+    // Full quads without padding, invalid chars are checked by OR.
+    const size_t full = (pad > 0 ? len - 4 : len);
+    for (size_t i = 0; i < full; i += 4, dst += 3) {
+      const uint8_t a = t[p[i]], b = t[p[i + 1]], c = t[p[i + 2]],
+        d = t[p[i + 3]];
+      if ((a | b | c | d) & 0xc0) {
+        return false;
+      }
+      const uint32_t v = (static_cast<uint32_t>(a) << 18) | (b << 12) |
+        (c << 6) | d;
+      dst[0] = static_cast<uint8_t>(v >> 16);
+      dst[1] = static_cast<uint8_t>(v >> 8);
+      dst[2] = static_cast<uint8_t>(v);
+    }
+    if (pad > 0) {
+      // Unused bits of the last quad must be zero to keep one encoding.
+      const uint8_t a = t[p[full]], b = t[p[full + 1]],
+        c = (pad == 1 ? t[p[full + 2]] : 0);
+      if (((a | b | c) & 0xc0) || (pad == 2 && (b & 0x0f)) ||
+          (pad == 1 && (c & 0x03))) {
+        return false;
+      }
+      dst[0] = static_cast<uint8_t>((a << 2) | (b >> 4));
+      if (pad == 1) {
+        dst[1] = static_cast<uint8_t>((b << 4) | (c >> 2));
+      }
+    }
+    return true;
+  }
+  
+  bool Var::check_hex(const argparse::StrView& val) {
+    const size_t skip = (has_hex_prefix(val) ? 2 : 0);
+    const unsigned char *p =
+      reinterpret_cast<const unsigned char*>(val.data()) + skip;
+    const size_t len = val.size() - skip;
+    if (len % 2 != 0 || (skip > 0 && len == 0)) {
+      return false;
+    }
+    
+    // OR of all lookups instead of a branch per digit.
+    const uint8_t *t = digit_tables.hex;
+    uint8_t bad = 0;
+    for (size_t i = 0; i < len; i++) {
+      bad |= t[p[i]];
+    }
+    return ! (bad & 0xf0);
+  }
+  
+  bool Var::check_base64(const argparse::StrView& val) {
+    const unsigned char *p =
+      reinterpret_cast<const unsigned char*>(val.data());
+    const size_t len = val.size();
+    if (len % 4 != 0) {
+      return false;
+    }
+    const size_t pad = (len == 0 ? 0 :
+                        p[len - 1] != '=' ? 0 : p[len - 2] != '=' ? 1 : 2);
+    
+    const uint8_t *t = digit_tables.b64;
+    const size_t full = (pad > 0 ? len - 4 : len);
+    uint8_t bad = 0;
+    for (size_t i = 0; i < full; i++) {
+      bad |= t[p[i]];
+    }
+    if (pad > 0) {
+      // Same as decode_base64 for the last quad.
+      const uint8_t a = t[p[full]], b = t[p[full + 1]],
+        c = (pad == 1 ? t[p[full + 2]] : 0);
+      bad |= (a | b | c);
+      if ((pad == 2 && (b & 0x0f)) || (pad == 1 && (c & 0x03))) {
+        return false;
+      }
+    }
+    return ! (bad & 0xc0);
   }
   
-  bool Values::is_true(const std::string &key) const {
-    auto arr = get_var_arr(*(this->varmap_.get()), key);
-    assert(arr.size() == 1);
-    return arr[0]->is_true();
+  size_t Var::decoded_size(const argparse::StrView& val,
+                           argparse::ArgType type) {
+    if (type == argparse::ArgType::HEX) {
+      return (val.size() - (has_hex_prefix(val) ? 2 : 0)) / 2;
+    }
+    size_t pad = 0;
+    while (pad < 2 && pad < val.size() && val[val.size() - 1 - pad] == '=') {
+      pad++;
+    }
+    return val.size() / 4 * 3 - pad;
   }
   
-  bool Values::is_set(const std::string& dest) const {
-    const VarMap& varmap = *(this->varmap_.get());
-    auto it = varmap.find(dest);
-    return (it != varmap.end());
+  void VarIntArray::push(const argparse::StrView& val) {
+    int64_t v;
+    NumResult r;
+    const char *name;
+    if (this->type_ == argparse::ArgType::INT64) {
+      r = Var::parse_int(val, INT64_MIN, INT64_MAX, &v);
+      name = "int64";
+    } else {
+      r = Var::parse_int(val, INT32_MIN, INT32_MAX, &v);
+      name = "int";
+    }
+    if (r != NumResult::ok) {
+      throw argparse::exception::ParseError(num_error(r, val, name));
+    }
+    this->values_.push_back(v);
   }
-
-  bool Values::is_help_mode() const {
-    return this->varmap_->is_help_mode();
+  
+  VarIntRanges::VarIntRanges(const argparse::StrView& val,
+                             argparse::ArgType type) : str_(val.str()) {
+    std::string err;
+    if (! this->value_.parse(val, &err)) {
+      this->set_err(err);
+    } else if (type == argparse::ArgType::PORTS &&
+               (this->value_.ranges().front().first < 0 ||
+                this->value_.ranges().back().last > 65535)) {
+      this->set_err("Out of range for port: " + val.str());
+    }
   }
-
-}
-
-
-
-// ==================================================================
-// Internal Classes
-//
-
-namespace argparse_internal {
   
-  Var* Var::build_var(const std::string& val, argparse::ArgType type) {
-    Var *opt = NULL;
-    
-    switch (type) {
-      case argparse::ArgType::INT:
-        opt = new VarInt(val);
-        break;
-        
-      case argparse::ArgType::STR:
-        opt = new VarStr(val);
-        break;
-
-      case argparse::ArgType::BOOL:
-        opt = new VarBool(val);
-        break;
+  VarIP::VarIP(const argparse::StrView& val, argparse::ArgType type)
+  : str_(val.str()) {
+    bool ok;
+    const char *name;
+    if (type == argparse::ArgType::IPV4) {
+      ok = argparse::IPAddress::parse_v4(val, &this->value_);
+      name = "IPv4";
+    } else if (type == argparse::ArgType::IPV6) {
+      ok = argparse::IPAddress::parse_v6(val, &this->value_);
+      name = "IPv6";
+    } else {
+      ok = argparse::IPAddress::parse(val, &this->value_);
+      name = "IP";
     }
-    
-    assert(opt);
-    
-    if (! opt->is_valid()) {
-      const std::string msg = opt->err();
-      delete opt;
-      throw argparse::exception::ParseError(msg);
+    if (! ok) {
+      memset(this->value_.bytes, 0, sizeof(this->value_.bytes));
+      this->set_err(std::string("Invalid ") + name + " address: " +
+                    val.str());
     }
-
-    return opt;
   }
   
+  VarMac::VarMac(const argparse::StrView& val) : str_(val.str()) {
+    if (! argparse::MacAddr::parse(val, &this->value_)) {
+      memset(this->value_.bytes, 0, sizeof(this->value_.bytes));
+      this->set_err("Invalid MAC address: " + val.str());
+    }
+  }
+  
+  VarBytes::VarBytes(const argparse::StrView& val, argparse::ArgType type)
+  : str_(val.str()) {
+    if (type == argparse::ArgType::HEX) {
+      if (! Var::decode_hex(val, &this->value_)) {
+        this->set_err("Invalid hex format: " + val.str());
+      }
+    } else if (! Var::decode_base64(val, &this->value_)) {
+      this->set_err("Invalid base64 format: " + val.str());
+    }
+  }
+  
+  VarCidr::VarCidr(const argparse::StrView& val) : str_(val.str()) {
+    std::string err;
+    if (! this->value_.add(val, &err)) {
+      this->set_err(err);
+    }
+  }
+  
+  void VarCidr::add(const argparse::StrView& val) {
+    std::string err;
+    if (! this->value_.add(val, &err)) {
+      throw argparse::exception::ParseError(err);
+    }
+    this->str_ += ',';
+    this->str_.append(val.data(), val.size());
+  }
+  
+  VarDouble::VarDouble(const argparse::StrView& val)
+  : value_(0), str_(val.str()) {
+    NumResult r = Var::parse_double(val, false, &this->value_);
+    if (r != NumResult::ok) {
+      this->set_err(num_error(r, val, "double"));
+    }
+  }
   
-  VarInt::VarInt(const std::string& val) {
-    char *e;
-    this->str_ = val;
-    this->value_ = strtol(val.c_str(), &e, 0);
-    if (*e != '\0') {
-      this->err_stream() << "Invalid number format: " << val;
+  VarFloat::VarFloat(const argparse::StrView& val)
+  : value_(0), str_(val.str()) {
+    double d;
+    NumResult r = Var::parse_double(val, true, &d);
+    if (r != NumResult::ok) {
+      this->set_err(num_error(r, val, "float"));
+    } else {
+      this->value_ = static_cast<float>(d);  // exact, d is rounded to float
     }
   }
   
   const std::string VarBool::true_("true");
   const std::string VarBool::false_("false");
 
-  VarBool::VarBool(const std::string& val) {
+  VarBool::VarBool(const argparse::StrView& val) : value_(false) {
     if (val == VarBool::true_) {
       this->value_ = true;
     } else if (val == VarBool::false_) {
       this->value_ = false;
     } else {
-      this->err_stream() << "Invalid bool format: " << val << ", " <<
-        "should be true or false";
+      this->set_err("Invalid bool format: " + val.str() + ", " +
+                    "should be true or false");
     }
   }
 
 
   
+  // ------------------------------------------------------------------
+  // class NameTrie
+  //
+  void NameTrie::clear() {
+    this->root_.children.clear();
+    this->root_.terminal = false;
+    this->root_.count = 0;
+  }
+  
+  size_t NameTrie::find_child(const Node& node, char c) {
+    size_t i = 0;
+    while (i < node.children.size() && node.children[i].label[0] != c) {
+      i++;
+    }
+    return i;
+  }
+  
+  void NameTrie::insert(const std::string& name) {
+    Node *node = &(this->root_);
+    size_t pos = 0;
+    node->count++;
+    
+    while (pos < name.length()) {
+      size_t i = NameTrie::find_child(*node, name[pos]);
+      if (i == node->children.size()) {
+        // New leaf which has all rest of name.
+        auto it = node->children.begin();
+        while (it != node->children.end() && it->label[0] < name[pos]) {
+          it++;
+        }
+        it = node->children.insert(it, Node(name.substr(pos)));
+        it->terminal = true;
+        it->count = 1;
+        return;
+      }
+      
+      Node *child = &(node->children[i]);
+      size_t len = 0;
+      while (len < child->label.length() && pos + len < name.length() &&
+             child->label[len] == name[pos + len]) {
+        len++;
+      }
+      
+      if (len < child->label.length()) {
+        // Split the edge at the first different character.
+        Node mid(child->label.substr(0, len));
+        mid.count = child->count;
+        child->label = child->label.substr(len);
+        mid.children.push_back(std::move(*child));
+        *child = std::move(mid);
+      }
+      
+      child->count++;
+      node = child;
+      pos += len;
+    }
+    
+    node->terminal = true;
+  }
+  
+  const NameTrie::Node* NameTrie::find(const std::string& prefix,
+                                       std::string *path) const {
+    const Node *node = &(this->root_);
+    size_t pos = 0;
+    
+    while (pos < prefix.length()) {
+      size_t i = NameTrie::find_child(*node, prefix[pos]);
+      if (i == node->children.size()) {
+        return nullptr;
+      }
+      
+      const Node *child = &(node->children[i]);
+      const std::string& label = child->label;
+      size_t len = 0;
+      while (len < label.length() && pos + len < prefix.length() &&
+             label[len] == prefix[pos + len]) {
+        len++;
+      }
+      
+      if (pos + len < prefix.length() && len < label.length()) {
+        return nullptr;  // Mismatch in the middle of the edge.
+      }
+      
+      node = child;
+      pos += len;
+      path->append(label);
+    }
+    
+    return node;
+  }
+  
+  void NameTrie::collect(const Node& node, std::string *buf,
+                         std::vector<std::string> *out) {
+    if (node.terminal) {
+      out->push_back(*buf);
+    }
+    for (const auto& child : node.children) {
+      buf->append(child.label);
+      NameTrie::collect(child, buf, out);
+      buf->erase(buf->length() - child.label.length());
+    }
+  }
+  
+  void NameTrie::complete(const std::string& prefix,
+                          std::vector<std::string> *out) const {
+    std::string path;
+    const Node *node = this->find(prefix, &path);
+    if (node != nullptr) {
+      NameTrie::collect(*node, &path, out);
+    }
+  }
+  
+  size_t NameTrie::resolve(const std::string& prefix, std::string *name) const {
+    std::string path;
+    const Node *node = this->find(prefix, &path);
+    if (node == nullptr) {
+      return 0;
+    }
+    
+    if (node->terminal && path == prefix) {
+      *name = path;
+      return 1;
+    }
+    
+    if (node->count == 1) {
+      // Only one path to the terminal node.
+      while (! node->terminal) {
+        node = &(node->children[0]);
+        path.append(node->label);
+      }
+      *name = path;
+    }
+    
+    return node->count;
+  }
+  
+  
+  // ------------------------------------------------------------------
+  // class BKTree
+  //
+  const size_t BKTree::NO_LIMIT;
+  
+  size_t BKTree::distance(const std::string& a, const std::string& b,
+                          std::vector<size_t> *buf, size_t limit) {
+    const size_t diff = (a.length() > b.length() ? a.length() - b.length() :
+                         b.length() - a.length());
+    if (diff > limit) {
+      return limit + 1;
+    }
+    
+    // Levenshtein distance with a single row.
+    std::vector<size_t>& row = *buf;
+    row.resize(b.length() + 1);
+    for (size_t j = 0; j <= b.length(); j++) {
+      row[j] = j;
+    }
+    
+    for (size_t i = 1; i <= a.length(); i++) {
+      size_t diag = row[0];
+      row[0] = i;
+      size_t row_min = row[0];
+      for (size_t j = 1; j <= b.length(); j++) {
+        size_t up = row[j];
+        size_t cost = (a[i - 1] == b[j - 1] ? 0 : 1);
+        row[j] = std::min(std::min(row[j - 1], up) + 1, diag + cost);
+        row_min = std::min(row_min, row[j]);
+        diag = up;
+      }
+      // Minimum of a row never decreases in following rows.
+      if (row_min > limit) {
+        return limit + 1;
+      }
+    }
+    
+    return (row[b.length()] > limit ? limit + 1 : row[b.length()]);
+  }
+  
+  void BKTree::insert(const std::string& name) {
+    if (this->nodes_.empty()) {
+      this->nodes_.emplace_back(name);
+      return;
+    }
+    
+    std::vector<size_t> buf;
+    size_t idx = 0;
+    while (true) {
+      size_t d = BKTree::distance(name, this->nodes_[idx].name, &buf);
+      if (d == 0) {
+        return;  // Already exists.
+      }
+      
+      size_t next = this->nodes_.size();
+      for (const auto& child : this->nodes_[idx].children) {
+        if (child.first == d) {
+          next = child.second;
+          break;
+        }
+      }
+      
+      if (next == this->nodes_.size()) {
+        this->nodes_[idx].children.push_back(std::make_pair(d, next));
+        this->nodes_[idx].max_edge = std::max(this->nodes_[idx].max_edge, d);
+        this->nodes_.emplace_back(name);
+        return;
+      }
+      idx = next;
+    }
+  }
+  
+  void BKTree::search(const std::string& query, size_t max_dist,
+                      size_t max_results,
+                      std::vector<std::string> *out) const {
+    if (this->nodes_.empty() || max_results == 0) {
+      return;
+    }
+    
+    std::vector<std::pair<size_t, size_t> > found;  // (distance, index)
+    std::vector<size_t> counts(max_dist + 1, 0);     // found by distance
+    std::vector<size_t> stack(1, 0), buf;
+    size_t radius = max_dist;
+    
+    while (! stack.empty()) {
+      const size_t idx = stack.back();
+      const Node& node = this->nodes_[idx];
+      stack.pop_back();
+      
+      // Over max_edge + radius, neither node nor children can be in range.
+      size_t d = BKTree::distance(query, node.name, &buf,
+                                  node.max_edge + radius);
+      if (d <= radius) {
+        found.push_back(std::make_pair(d, idx));
+        counts[d]++;
+        // Names farther than the max_results-th closest are not needed.
+        size_t n = 0;
+        for (size_t r = 0; r < radius; r++) {
+          n += counts[r];
+          if (n >= max_results) {
+            radius = r;
+            break;
+          }
+        }
+      }
+      
+      // Only children in [d - radius, d + radius] can be in range.
+      for (const auto& child : node.children) {
+        if (child.first + radius >= d && child.first <= d + radius) {
+          stack.push_back(child.second);
+        }
+      }
+    }
+    
+    std::sort(found.begin(), found.end());
+    for (size_t i = 0; i < found.size() && i < max_results; i++) {
+      out->push_back(this->nodes_[found[i].second].name);
+    }
+  }
+  
+  
+  // ------------------------------------------------------------------
+  // class LimitCounter
+  //
+  bool LimitCounter::add(const argparse::StrView& arg, std::string *err) {
+    if (! this->skip(1, err)) {
+      return false;
+    }
+    
+    this->bytes_ += arg.size();
+    if (this->limits_.max_bytes > 0 && this->bytes_ > this->limits_.max_bytes) {
+      *err = ("too long arguments, limit is " +
+              std::to_string(this->limits_.max_bytes) + " bytes");
+      return false;
+    }
+    
+    if (this->terminated_) {
+      return true;
+    } else if (arg == "--") {
+      this->terminated_ = true;
+    } else if (this->limits_.max_cluster > 0 &&
+               arg.size() > this->limits_.max_cluster + 1 &&
+               arg[0] == '-' && arg[1] != '-') {
+      *err = ("too long option cluster, limit is " +
+              std::to_string(this->limits_.max_cluster) + " letters");
+      return false;
+    }
+    
+    return true;
+  }
+  
+  bool LimitCounter::add(const char *arg, size_t *len, std::string *err) {
+    // A huge argument is not read over max_bytes.
+    const size_t max_bytes = this->limits_.max_bytes;
+    if (max_bytes > 0) {
+      *len = strnlen(arg, (this->bytes_ < max_bytes ?
+                           max_bytes - this->bytes_ : 0) + 1);
+    } else {
+      *len = strlen(arg);
+    }
+    return this->add(argparse::StrView(arg, *len), err);
+  }
+  
+  bool LimitCounter::skip(size_t n, std::string *err) {
+    this->argc_ += n;
+    if (this->limits_.max_args > 0 && this->argc_ > this->limits_.max_args) {
+      *err = ("too many arguments, limit is " +
+              std::to_string(this->limits_.max_args));
+      return false;
+    }
+    return true;
+  }
+  
   
   // ------------------------------------------------------------------
   // class ArgumentProcessor
   //
-  size_t ArgumentProcessor::parse_option(const argparse::Argv& args,
-                                         size_t idx,
-                                         const std::string& optkey,
-                                         argparse::VarMap *varmap) const {
+  const argparse::Argument*
+  ArgumentProcessor::resolve_option(const std::string& optkey, bool is_long,
+                                    bool *ambiguous) const {
+    *ambiguous = false;
     auto it = this->argmap_.find(optkey);
-    if (it == this->argmap_.end()) {
-      throw argparse::exception::ParseError("option not found: " + optkey);
+    if (it != this->argmap_.end()) {
+      return it->second.get();
+    }
+    
+    // A letter of "-abc" is not a prefix, and the trie decides uniqueness
+    // of a long one even if it's one letter as "--o".
+    if (this->allow_abbrev_ && is_long) {
+      std::string name;
+      size_t n = this->name_trie_.resolve("--" + optkey, &name);
+      if (n == 1) {
+        return this->argmap_.find(name.substr(2))->second.get();
+      }
+      *ambiguous = (n > 1);
+    }
+    
+    return nullptr;
+  }
+  
+  const argparse::Argument*
+  ArgumentProcessor::lookup_option(const std::string& optkey,
+                                   bool is_long) const {
+    bool ambiguous;
+    const argparse::Argument *arg = this->resolve_option(optkey, is_long,
+                                                         &ambiguous);
+    if (ambiguous) {
+      throw_ambiguous(this->name_trie_, optkey);
     }
-
-    std::shared_ptr<argparse::Argument> argument = it->second;
     
+    return arg;
+  }
+  
+  const argparse::Argument&
+  ArgumentProcessor::find_option(const std::string& optkey,
+                                 bool is_long) const {
+    const argparse::Argument *arg = this->lookup_option(optkey, is_long);
+    if (arg == nullptr) {
+      throw_not_found(this->suggestion_tree(), optkey);
+    }
+    return *arg;
+  }
+  
+  void ArgumentProcessor::throw_ambiguous(const NameTrie& trie,
+                                          const std::string& optkey) {
+    std::vector<std::string> candidates;
+    trie.complete("--" + optkey, &candidates);
+    std::stringstream ss;
+    ss << "ambiguous option: --" << optkey << " could match";
+    for (size_t i = 0; i < candidates.size(); i++) {
+      ss << (i > 0 ? ", " : " ") << candidates[i];
+    }
+    throw argparse::exception::ParseError(ss.str());
+  }
+  
+  void ArgumentProcessor::throw_not_found(const BKTree& tree,
+                                          const std::string& optkey) {
+    std::vector<std::string> suggestions;
+    if (optkey.length() > 1) {
+      const size_t max_dist = (optkey.length() < 6 ? 1 : 2);
+      tree.search("--" + optkey, max_dist, 3, &suggestions);
+    }
+    throw argparse::exception::ParseError("option not found: " + optkey,
+                                          suggestions);
+  }
+  
+  size_t ArgumentProcessor::parse_option(const argparse::ArgvView& args,
+                                         size_t idx,
+                                         const argparse::Argument& argument,
+                                         const std::string& optkey,
+                                         argparse::VarMap *varmap,
+                                         const argparse::StrView *inline_val) {
     // No parsing option if help
-    if (argument->get_action() == argparse::Action::help) {
+    if (argument.get_action() == argparse::Action::help) {
       varmap->set_help_mode(true);
       return idx;
     }
     
+    std::vector<Var*> *vars = ArgumentProcessor::dest_vars(argument, optkey,
+                                                           varmap);
+    idx = argument.parse(args, idx, vars, inline_val);
+    varmap->check_values(argument.get_dest(), *vars);
     
-    const std::string& dest = argument->get_dest();
+    return idx;
+  }
+  
+  std::vector<Var*>* ArgumentProcessor::dest_vars(
+    const argparse::Argument& argument, const std::string& optkey,
+    argparse::VarMap *varmap) {
+    const std::string& dest = argument.get_dest();
     auto vit = varmap->find(dest);
 
-    std::vector<Var*> *vars = nullptr;
-    
     if (vit != varmap->end()) {
-      if (argument->get_action() != argparse::Action::append &&
-          argument->get_action() != argparse::Action::append_const &&
-          argument->get_action() != argparse::Action::count) {
+      if (argument.get_action() != argparse::Action::append &&
+          argument.get_action() != argparse::Action::append_const &&
+          argument.get_action() != argparse::Action::count) {
           throw argparse::exception::ParseError("duplicated option, " + optkey);
       }
       
-      vars = vit->second;
-    } else {
-      vars = new std::vector<Var*>();
-      varmap->insert(std::make_pair(dest, vars));
+      return vit->second;
     }
     
-    idx = argument->parse(args, idx, vars);
-    
-    return idx;
+    std::vector<Var*> *vars = new std::vector<Var*>();
+    varmap->insert(std::make_pair(dest, vars));
+    return vars;
   }
 
   argparse::Argument& ArgumentProcessor::add_argument(const std::string &name) {
@@ -771,32 +4023,155 @@ namespace argparse_internal {
       throw argparse::exception::ConfigureError("duplicated option name", name);
     }
     
-    std::shared_ptr<argparse::Argument> ptr(arg);
-    this->argmap_.insert(std::make_pair(name, ptr));
-  }
-
-  void ArgumentProcessor::copy_option(const std::string& src,
-                                      const std::string& dst) {
-    auto it = this->argmap_.find(src);
-    if (it == this->argmap_.end()) {
-      throw argparse::exception::ConfigureError("can not copy option from " +
-                                                src, dst);
+    std::shared_ptr<argparse::Argument> ptr(arg);
+    this->argmap_.insert(std::make_pair(name, ptr));
+    this->invalidate();
+  }
+
+  void ArgumentProcessor::copy_option(const std::string& src,
+                                      const std::string& dst) {
+    auto it = this->argmap_.find(src);
+    if (it == this->argmap_.end()) {
+      throw argparse::exception::ConfigureError("can not copy option from " +
+                                                src, dst);
+    }
+
+    if (this->argmap_.find(dst) != this->argmap_.end()) {
+      throw argparse::exception::ConfigureError("duplicated option name", dst);
+    }
+
+    this->argmap_.insert(std::make_pair(dst, it->second));
+    this->invalidate();
+  }
+  
+  void ArgumentProcessor::insert_sequence(argparse::Argument *arg) {
+    // std::unique_ptr<argparse::Argument> ptr(arg);
+    this->argvec_.emplace_back(arg);
+    this->invalidate();
+  }
+  
+  void ArgumentProcessor::freeze() const {
+    if (this->frozen_.load(std::memory_order_acquire)) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(this->freeze_mutex_);
+    if (this->frozen_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    
+    this->name_trie_.clear();
+    this->name_bktree_.clear();
+    this->bktree_built_.store(false, std::memory_order_relaxed);
+    this->dest_ids_.clear();
+    for (const auto& it : this->argmap_) {
+      this->name_trie_.insert((it.first.length() > 1 ? "--" : "-") + it.first);
+    }
+    
+    // Options and sequence arguments sharing a dest have same id.
+    for (const auto& it : this->argmap_) {
+      auto r = this->dest_ids_.insert(std::make_pair(it.second->get_dest(),
+                                                     this->dest_ids_.size()));
+      it.second->set_dest_id(r.first->second);
+    }
+    for (const auto& arg : this->argvec_) {
+      auto r = this->dest_ids_.insert(std::make_pair(arg->get_dest(),
+                                                     this->dest_ids_.size()));
+      arg->set_dest_id(r.first->second);
+    }
+    
+    const size_t n = this->argvec_.size();
+    this->seq_min_.assign(n + 1, 0);
+    for (size_t i = n; i > 0; i--) {
+      this->seq_min_[i - 1] = (this->seq_min_[i] +
+                               this->argvec_[i - 1]->min_nargs());
+    }
+    
+    this->frozen_.store(true, std::memory_order_release);
+  }
+  
+  const BKTree& ArgumentProcessor::suggestion_tree() const {
+    if (this->bktree_built_.load(std::memory_order_acquire)) {
+      return this->name_bktree_;
+    }
+    std::lock_guard<std::mutex> lock(this->freeze_mutex_);
+    if (! this->bktree_built_.load(std::memory_order_relaxed)) {
+      this->name_bktree_.clear();
+      for (const auto& it : this->argmap_) {
+        if (it.first.length() > 1) {
+          this->name_bktree_.insert("--" + it.first);
+        }
+      }
+      this->bktree_built_.store(true, std::memory_order_release);
+    }
+    return this->name_bktree_;
+  }
+  
+  size_t ArgumentProcessor::dest_id(const std::string& dest) const {
+    auto it = this->dest_ids_.find(dest);
+    if (it == this->dest_ids_.end()) {
+      throw argparse::exception::KeyError(dest, "not found in options");
+    }
+    return it->second;
+  }
+  
+  size_t ArgumentProcessor::find_over_limit(const argparse::Limits& limits,
+                                            const argparse::ArgvView& args,
+                                            std::string *err) {
+    if (! LimitCounter(limits).skip(args.size(), err)) {
+      return limits.max_args;
+    }
+    
+    LimitCounter counter(limits);
+    for (size_t i = 0; i < args.size(); i++) {
+      if (! counter.add(args[i], err)) {
+        return i;
+      }
     }
-
-    if (this->argmap_.find(dst) != this->argmap_.end()) {
-      throw argparse::exception::ConfigureError("duplicated option name", dst);
+    return args.size();
+  }
+  
+  void ArgumentProcessor::check_limits(const argparse::Limits& limits,
+                                       const argparse::ArgvView& args) {
+    std::string err;
+    if (find_over_limit(limits, args, &err) < args.size()) {
+      throw argparse::exception::ParseError(err);
     }
-
-    this->argmap_.insert(std::make_pair(dst, it->second));
   }
   
-  void ArgumentProcessor::insert_sequence(argparse::Argument *arg) {
-    // std::unique_ptr<argparse::Argument> ptr(arg);
-    this->argvec_.emplace_back(arg);
+  TokenType ArgumentProcessor::split_token(const argparse::StrView& arg,
+                                           std::string *key,
+                                           argparse::StrView *val,
+                                           bool *has_val) {
+    *has_val = false;
+    
+    if (arg == "--") {
+      return TokenType::terminator;
+    } else if (arg.substr(0, 3) == "---") {
+      throw argparse::exception::ParseError("too long hyphen. "
+                                            "Supporting only 1 or 2: " +
+                                            arg.str());
+    } else if (arg.substr(0, 2) == "--") {
+      // Split "--name=value" at the first '=', value is not copied.
+      const char *eq = static_cast<const char*>(
+        memchr(arg.data() + 2, '=', arg.size() - 2));
+      const char *end = arg.data() + arg.size();
+      key->assign(arg.data() + 2, (eq == nullptr ? end : eq));
+      if (eq != nullptr) {
+        *val = argparse::StrView(eq + 1, end - (eq + 1));
+        *has_val = true;
+      }
+      return TokenType::long_option;
+    } else if (arg.substr(0, 1) == "-") {
+      key->assign(arg.data() + 1, arg.size() - 1);
+      return TokenType::short_options;
+    }
+    
+    return TokenType::sequence;
   }
   
-  argparse::Values ArgumentProcessor::parse_args(const argparse::Argv& args)
-  const {
+  std::shared_ptr<argparse::VarMap> ArgumentProcessor::prepare() const {
+    this->freeze();
+    
     // Checking consistency of Argument instances.
     for (auto it : this->argmap_) {
       (it.second)->check_consistency();
@@ -805,11 +4180,9 @@ namespace argparse_internal {
       this->argvec_[i]->check_consistency();
     }
     
-    
-
     std::shared_ptr<argparse::VarMap> ptr =
       std::make_shared<argparse::VarMap>();
-    size_t seq_idx = 0;
+    ptr->set_max_values(this->limits_.max_values);
     
     // Setting default value for 'count' options before parsing.
     for (auto it : this->argmap_) {
@@ -822,44 +4195,66 @@ namespace argparse_internal {
       }
     }
     
-    // Start parsing.
-    for (size_t idx = 1; idx < args.size(); ) {
-      const std::string& arg = args[idx];
+    return ptr;
+  }
+  
+  void ArgumentProcessor::parse_sequences(const argparse::ArgvView& args,
+                                          const std::vector<size_t>& seq,
+                                          argparse::VarMap *varmap,
+                                          std::vector<size_t> *extra) const {
+    // Decide number of arguments for each sequence argument in one pass.
+    // Earlier ones take as many as possible, but keep minimum numbers for
+    // following ones, e.g. "SRC [SRC ...] DST".
+    this->freeze();
+    const size_t n = this->argvec_.size();
+    
+    size_t pos = 0;
+    for (size_t i = 0; i < n && pos < seq.size(); i++) {
+      const argparse::Argument& arg = *(this->argvec_[i]);
+      const size_t remain = seq.size() - pos;
+      const size_t avail = (remain > this->seq_min_[i + 1] ?
+                            remain - this->seq_min_[i + 1] : 0);
+      const size_t take = std::min(remain, std::min(arg.max_nargs(),
+                                                    std::max(arg.min_nargs(),
+                                                             avail)));
+      if (take == 0) {
+        continue;
+      }
       
-      if (arg.substr(0, 3) == "---") {
-        throw argparse::exception::ParseError("too long hyphen. "
-                                              "Supporting only 1 or 2: " + arg);
-      } else if (arg.substr(0, 2) == "--") {
-        const std::string key = arg.substr(2);
-        idx = this->parse_option(args, idx + 1, key, ptr.get());
-      } else if (arg.substr(0, 1) == "-") {
-        idx = idx + 1;
-        for (size_t c = 1; c < arg.length(); c++) {
-          const std::string key = arg.substr(c, 1);
-          idx = this->parse_option(args, idx, key, ptr.get());
-        }
+      argparse::ArgvView values;
+      for (size_t j = pos; j < pos + take; j++) {
+        values.push_back(args[seq[j]]);
+      }
+      pos += take;
+      
+      std::vector<Var*> *vararr = nullptr;
+      auto vit = varmap->find(arg.get_dest());
+      if (vit == varmap->end()) {
+        vararr = new std::vector<Var*>();
+        varmap->insert(std::make_pair(arg.get_dest(), vararr));
       } else {
-        if (this->argvec_.size() <= seq_idx) {
-          throw argparse::exception::ParseError("too long arguments after " +
-                                                args[idx]);
-        }
-        
-        const std::string& dest = this->argvec_[seq_idx]->get_dest();
-        std::vector<Var*> *vararr = nullptr;
-        auto vit = ptr->find(dest);
-        if (vit == ptr->end()) {
-          vararr = new std::vector<Var*>();
-          ptr->insert(std::make_pair(dest, vararr));
-        } else {
-          vararr = vit->second;
-        }
-        assert(vararr != nullptr);
-        
-        idx = this->argvec_[seq_idx]->parse(args, idx, vararr);
-        seq_idx++;
+        vararr = vit->second;
       }
+      arg.parse(values, 0, vararr);
+      varmap->check_values(arg.get_dest(), *vararr);
     }
-
+    
+    if (pos < seq.size()) {
+      if (extra == nullptr) {
+        throw argparse::exception::ParseError("too long arguments after " +
+                                              args[seq[pos]].str());
+      }
+      extra->insert(extra->end(), seq.begin() + pos, seq.end());
+    }
+  }
+  
+  argparse::Values
+  ArgumentProcessor::finish(std::shared_ptr<argparse::VarMap> ptr,
+                            const argparse::ArgvSpan *rest) const {
+    if (rest != nullptr) {
+      ptr->set_rest(*rest);
+    }
+    
     // Setting default value if missing option.
     for (auto it : this->argmap_) {
       auto& arg = (it.second);
@@ -878,7 +4273,7 @@ namespace argparse_internal {
           if (!v_default.empty()) {
             // The option has default and was not specified in argument.
             auto vars = new std::vector<Var*>();
-            vars->emplace_back(Var::build_var(v_default, arg->get_type()));
+            vars->emplace_back(arg->build_var(v_default));
             ptr->insert(std::make_pair(dest, vars));
           }
         }
@@ -900,24 +4295,169 @@ namespace argparse_internal {
           ptr->insert(std::make_pair(dest, vars));
         }
       }
-      
-      // Checking required options.
-      // This check should be done after setting default values.
-      for (auto it : this->argmap_) {
-        auto& arg = (it.second);
-        auto& dest = arg->get_dest();
-        if (ptr->find(dest) == ptr->end() && arg->is_required()) {
-          std::stringstream ss;
-          ss << "option '" << arg->get_name() << "' is required";
-          throw argparse::exception::ParseError(ss.str());
-        }
+    }
+    
+    // Checking required options.
+    // This check should be done after setting default values.
+    for (auto it : this->argmap_) {
+      auto& arg = (it.second);
+      auto& dest = arg->get_dest();
+      if (ptr->find(dest) == ptr->end() && arg->is_required()) {
+        std::stringstream ss;
+        ss << "option '" << arg->get_name() << "' is required";
+        throw argparse::exception::ParseError(ss.str());
       }
-      
     }
     
     argparse::Values vals(ptr);
     return vals;
   }
+  
+  argparse::Values
+  ArgumentProcessor::parse_args(const argparse::ArgvView& args,
+                                const argparse::ArgvSpan *rest,
+                                argparse::ArgvView *unknown) const {
+    this->check_limits(args);
+    std::shared_ptr<argparse::VarMap> ptr = this->prepare();
+    std::vector<size_t> seq, unknown_idx;
+    
+    // Start parsing. Sequence arguments are matched after all options.
+    for (size_t idx = 1; idx < args.size(); ) {
+      const argparse::StrView& arg = args[idx];
+      std::string key;
+      argparse::StrView val;
+      bool has_val;
+      
+      switch (ArgumentProcessor::split_token(arg, &key, &val, &has_val)) {
+        case TokenType::terminator:
+          // Stop parsing, rest of arguments are passed through.
+          ptr->set_rest(args, idx + 1);
+          idx = args.size();
+          break;
+          
+        case TokenType::long_option: {
+          const argparse::Argument *opt = (unknown != nullptr ?
+                                           this->lookup_option(key, true) :
+                                           &(this->find_option(key, true)));
+          if (opt == nullptr) {
+            unknown_idx.push_back(idx);
+            idx++;
+          } else {
+            idx = ArgumentProcessor::parse_option(args, idx + 1, *opt, key,
+                                                  ptr.get(),
+                                                  (has_val ? &val : nullptr));
+          }
+          break;
+        }
+          
+        case TokenType::short_options: {
+          bool known = true;
+          for (size_t c = 0; unknown != nullptr && c < key.length(); c++) {
+            known = known && (this->lookup_option(key.substr(c, 1), false) !=
+                              nullptr);
+          }
+          
+          if (! known) {
+            // Whole of "-abc" is unknown if one of them is unknown.
+            unknown_idx.push_back(idx);
+            idx++;
+            break;
+          }
+          
+          idx = idx + 1;
+          for (size_t c = 0; c < key.length(); c++) {
+            const std::string optkey = key.substr(c, 1);
+            idx = ArgumentProcessor::parse_option(args, idx,
+                                                  this->find_option(optkey,
+                                                                    false),
+                                                  optkey, ptr.get(), nullptr);
+          }
+          break;
+        }
+          
+        case TokenType::sequence:
+          seq.push_back(idx);
+          idx++;
+          break;
+      }
+    }
+    
+    std::vector<size_t> extra;
+    this->parse_sequences(args, seq, ptr.get(),
+                          (unknown != nullptr ? &extra : nullptr));
+    
+    if (unknown != nullptr && ! args.empty()) {
+      // Keep order of original arguments.
+      std::vector<size_t> idxs(unknown_idx.size() + extra.size());
+      std::merge(unknown_idx.begin(), unknown_idx.end(), extra.begin(),
+                 extra.end(), idxs.begin());
+      unknown->push_back(args[0]);
+      for (auto i : idxs) {
+        unknown->push_back(args[i]);
+      }
+    }
+    
+    return this->finish(ptr, rest);
+  }
+
+  const argparse::Argument*
+  ArgumentProcessor::choice_option(const std::string& optkey,
+                                   bool is_long) const {
+    bool ambiguous;
+    const argparse::Argument *arg = this->resolve_option(optkey, is_long,
+                                                         &ambiguous);
+    if (arg == nullptr || arg->get_choices().empty()) {
+      return nullptr;
+    }
+    return arg;
+  }
+  
+  void ArgumentProcessor::complete(const argparse::ArgvView& words,
+                                   size_t cword, std::ostream *out) const {
+    this->freeze();
+    complete(this->name_trie_,
+             [this](const std::string& optkey, bool is_long) {
+               return this->choice_option(optkey, is_long);
+             }, words, cword, out);
+  }
+  
+  void ArgumentProcessor::complete(const NameTrie& trie,
+                                   const ChoiceLookup& choice,
+                                   const argparse::ArgvView& words,
+                                   size_t cword, std::ostream *out) {
+    const std::string cur = (cword < words.size() ? words[cword].str() : "");
+    std::vector<std::string> candidates;
+    const size_t eq = cur.find('=');
+    
+    if (cur.substr(0, 2) == "--" && eq != std::string::npos) {
+      // Choices of "--name=value".
+      const argparse::Argument *arg = choice(cur.substr(2, eq - 2), true);
+      if (arg != nullptr) {
+        arg->complete_choice(cur.substr(eq + 1), &candidates);
+        for (auto& c : candidates) {
+          c = cur.substr(0, eq + 1) + c;
+        }
+      }
+    } else if (cur.substr(0, 1) == "-") {
+      trie.complete(cur, &candidates);
+    } else if (cword > 0 && cword <= words.size()) {
+      // Choices for value of previous option, e.g. "--mode" or "-vm".
+      const std::string prev = words[cword - 1].str();
+      const argparse::Argument *arg = nullptr;
+      if (prev.substr(0, 2) == "--") {
+        arg = choice(prev.substr(2), true);
+      } else if (prev.length() > 1 && prev[0] == '-') {
+        arg = choice(prev.substr(prev.length() - 1), false);
+      }
+      if (arg != nullptr) {
+        arg->complete_choice(cur, &candidates);
+      }
+    }
+    
+    for (const auto& c : candidates) {
+      *out << c << std::endl;
+    }
+  }
 
   void ArgumentProcessor::handle_usage_line(const argparse::Argument& arg,
                                             const std::string& tab,
@@ -971,6 +4511,17 @@ namespace argparse_internal {
   
   void ArgumentProcessor::usage(const std::string& prog_name,
                                 std::ostream *out) const {
+    usage(prog_name, std::vector<const ArgumentProcessor*>(1, this), out);
+  }
+  
+  void ArgumentProcessor::help(std::ostream *out) const {
+    help(std::vector<const ArgumentProcessor*>(1, this), out);
+  }
+  
+  void ArgumentProcessor::usage(const std::string& prog_name,
+                                const std::vector<const ArgumentProcessor*>&
+                                procs,
+                                std::ostream *out) {
     std::stringstream ss, tab;
     std::set<std::string> done_args;
     
@@ -979,45 +4530,493 @@ namespace argparse_internal {
       tab << " ";
     }
     
-    for (auto it : this->argmap_) {
-      const std::string& name = it.second->get_name();
-      if (done_args.find(name) == done_args.end()) {
-        done_args.insert(name);
-        handle_usage_line(*(it.second), tab.str(), &ss, out);
+    for (auto proc : procs) {
+      for (auto it : proc->argmap_) {
+        const std::string& name = it.second->get_name();
+        if (done_args.find(name) == done_args.end()) {
+          done_args.insert(name);
+          handle_usage_line(*(it.second), tab.str(), &ss, out);
+        }
       }
     }
 
-    for (size_t n = 0; n < this->argvec_.size(); n++) {
-      const std::string& name = this->argvec_[n]->get_name();
-      if (done_args.find(name) == done_args.end()) {
-        done_args.insert(name);
-        handle_usage_line(*(this->argvec_[n]), tab.str(), &ss, out);
+    for (auto proc : procs) {
+      for (size_t n = 0; n < proc->argvec_.size(); n++) {
+        const std::string& name = proc->argvec_[n]->get_name();
+        if (done_args.find(name) == done_args.end()) {
+          done_args.insert(name);
+          handle_usage_line(*(proc->argvec_[n]), tab.str(), &ss, out);
+        }
       }
     }
     
     *out << ss.str() << std::endl;
   }
   
-  void ArgumentProcessor::help(std::ostream *out) const {
+  void ArgumentProcessor::help(const std::vector<const ArgumentProcessor*>&
+                               procs,
+                               std::ostream *out) {
     std::set<std::string> done_args;
 
     *out << std::endl << "positional arguments:" << std::endl;
-    for (size_t n = 0; n < this->argvec_.size(); n++) {
-      const std::string& name = this->argvec_[n]->get_name();
-      if (done_args.find(name) == done_args.end()) {
-        done_args.insert(name);
-        handle_help_line(*(this->argvec_[n]), out);
+    for (auto proc : procs) {
+      for (size_t n = 0; n < proc->argvec_.size(); n++) {
+        const std::string& name = proc->argvec_[n]->get_name();
+        if (done_args.find(name) == done_args.end()) {
+          done_args.insert(name);
+          handle_help_line(*(proc->argvec_[n]), out);
+        }
       }
     }
 
+    // Options of dotted dest such as "db.pool.size" are grouped by prefix.
+    std::map<std::string, std::vector<const argparse::Argument*>> groups;
     *out << std::endl << "optional arguments:" << std::endl;
-    for (auto it : this->argmap_) {
-      const std::string& name = it.second->get_name();
-      if (done_args.find(name) == done_args.end()) {
+    for (auto proc : procs) {
+      for (auto it : proc->argmap_) {
+        const std::string& name = it.second->get_name();
+        if (done_args.find(name) != done_args.end()) {
+          continue;
+        }
         done_args.insert(name);
-        handle_help_line(*(it.second), out);
+        const std::string& dest = it.second->get_dest();
+        const size_t dot = dest.rfind('.');
+        if (dot != std::string::npos && dot > 0) {
+          groups[dest.substr(0, dot)].push_back(it.second.get());
+        } else {
+          handle_help_line(*(it.second), out);
+        }
+      }
+    }
+    
+    for (const auto& g : groups) {
+      *out << std::endl << g.first << ":" << std::endl;
+      for (auto arg : g.second) {
+        handle_help_line(*arg, out);
+      }
+    }
+  }
+
+
+  // ------------------------------------------------------------------
+  // class EventCursor
+  //
+  static bool is_dash(const argparse::StrView& arg) {
+    return (! arg.empty() && arg[0] == '-');
+  }
+  
+  EventCursor::EventCursor(const ArgumentProcessor& proc,
+                           const argparse::ArgvView& args, bool convert)
+  : proc_(proc), args_(args), idx_(1), key_pos_(0), opt_idx_(0),
+    opt_(nullptr), opt_count_(0), seq_total_(0), seq_pos_(0), seq_arg_(0),
+    seq_left_(0), convert_(convert), done_(false), err_(Error::none), err_idx_(0),
+    err_arg_(nullptr), err_long_(false) {
+    proc.freeze();
+    for (const auto& it : proc.options()) {
+      (it.second)->check_consistency();
+    }
+    for (const auto& arg : proc.sequences()) {
+      arg->check_consistency();
+    }
+    
+    this->seen_.assign(proc.dest_count(), false);
+    if (proc.limits().max_values > 0) {
+      this->values_.assign(proc.dest_count(), 0);
+    }
+    
+    const size_t over = proc.find_over_limit(args, &this->err_key_);
+    if (over < args.size()) {
+      this->fail(Error::limit_exceeded, over, nullptr);
+      return;
+    }
+    
+    if (proc.has_sequence()) {
+      this->seq_total_ = this->count_sequences();
+    }
+  }
+  
+  size_t EventCursor::count_sequences() const {
+    // Skip values of options as Argument::parse does. Errors are left to
+    // next(), which finds them before reaching following arguments.
+    std::string key;
+    size_t count = 0;
+    
+    for (size_t i = 1; i < this->args_.size(); i++) {
+      const argparse::StrView& arg = this->args_[i];
+      if (! is_dash(arg)) {
+        count++;
+        continue;
+      }
+      if (arg == "--") {
+        break;
+      }
+      
+      const bool is_long = (arg.substr(0, 2) == "--");
+      const argparse::StrView name = arg.substr(is_long ? 2 : 1);
+      if (is_long && memchr(name.data(), '=', name.size()) != nullptr) {
+        continue;  // "--name=value" has no following value.
+      }
+      
+      for (size_t c = 0; c < (is_long ? 1 : name.size()); c++) {
+        if (is_long) {
+          key.assign(name.data(), name.size());
+        } else {
+          key.assign(1, name[c]);
+        }
+        
+        bool ambiguous;
+        const argparse::Argument *opt = this->proc_.resolve_option(key,
+                                                                   is_long,
+                                                                   &ambiguous);
+        if (opt == nullptr) {
+          continue;
+        }
+        
+        const size_t max = opt->max_nargs();
+        for (size_t n = 0; n < max && i + 1 < this->args_.size() &&
+               ! is_dash(this->args_[i + 1]); n++) {
+          i++;
+        }
+      }
+    }
+    
+    return count;
+  }
+  
+  bool EventCursor::next(argparse::Event *ev) {
+    while (this->err_ == Error::none) {
+      if (this->opt_ != nullptr) {
+        // Values of current option.
+        const argparse::Argument& opt = *(this->opt_);
+        if (this->opt_count_ < opt.max_nargs() &&
+            this->idx_ < this->args_.size() &&
+            ! is_dash(this->args_[this->idx_])) {
+          this->opt_count_++;
+          this->idx_++;
+          return this->emit(opt, this->args_[this->idx_ - 1],
+                            this->idx_ - 1, ev);
+        }
+        
+        this->opt_ = nullptr;
+        if (this->opt_count_ < opt.min_nargs()) {
+          return this->fail(Error::missing_value, this->opt_idx_, &opt);
+        }
+        if (this->opt_count_ == 0 && opt.max_nargs() == 1) {
+          // nargs '?' without value.
+          return this->emit(opt, opt.get_const(), this->opt_idx_, ev);
+        }
+        continue;
+      }
+      
+      if (this->key_pos_ < this->key_.size()) {
+        // Next letter of "-abc".
+        this->letter_.assign(1, this->key_[this->key_pos_++]);
+        if (this->open(this->letter_, false, nullptr, ev)) {
+          return true;
+        }
+        continue;
+      }
+      
+      if (this->idx_ >= this->args_.size()) {
+        return this->finish();
+      }
+      
+      const argparse::StrView& arg = this->args_[this->idx_];
+      if (arg.substr(0, 3) == "---") {
+        return this->fail(Error::bad_hyphen, this->idx_, nullptr);
+      }
+      
+      argparse::StrView val;
+      bool has_val;
+      TokenType type = ArgumentProcessor::split_token(arg, &this->key_, &val,
+                                                      &has_val);
+      this->opt_idx_ = this->idx_;
+      this->idx_++;
+      
+      switch (type) {
+        case TokenType::terminator:
+          // Rest of arguments are not parsed, position() points them.
+          return this->finish();
+          
+        case TokenType::long_option:
+          this->key_pos_ = this->key_.size();
+          if (this->open(this->key_, true, (has_val ? &val : nullptr),
+                         ev)) {
+            return true;
+          }
+          break;
+          
+        case TokenType::short_options:
+          this->key_pos_ = 0;
+          break;
+          
+        case TokenType::sequence:
+          return this->sequence(ev);
+      }
+    }
+    
+    return false;
+  }
+  
+  bool EventCursor::open(const std::string& key, bool is_long,
+                         const argparse::StrView *inline_val,
+                         argparse::Event *ev) {
+    bool ambiguous;
+    const argparse::Argument *arg = this->proc_.resolve_option(key, is_long,
+                                                               &ambiguous);
+    if (arg == nullptr) {
+      this->err_key_ = key;
+      this->err_long_ = is_long;
+      return this->fail((ambiguous ? Error::ambiguous_option :
+                         Error::unknown_option), this->opt_idx_, nullptr);
+    }
+    
+    const argparse::Action action = arg->get_action();
+    if (action != argparse::Action::help) {
+      // Same rule as ArgumentProcessor::dest_vars.
+      if (this->seen_[arg->get_dest_id()] &&
+          action != argparse::Action::append &&
+          action != argparse::Action::append_const &&
+          action != argparse::Action::count) {
+        this->err_key_ = key;
+        return this->fail(Error::duplicated_option, this->opt_idx_, arg);
+      }
+      this->seen_[arg->get_dest_id()] = true;
+    }
+    
+    if (inline_val != nullptr) {
+      if ((action != argparse::Action::store &&
+           action != argparse::Action::append) ||
+          (arg->min_nargs() == arg->max_nargs() && arg->max_nargs() != 1)) {
+        return this->fail(Error::unexpected_value, this->opt_idx_, arg);
+      }
+      return this->emit(*arg, *inline_val, this->opt_idx_, ev);
+    }
+    
+    switch (action) {
+      case argparse::Action::store:
+      case argparse::Action::append:
+        this->opt_ = arg;
+        this->opt_count_ = 0;
+        return false;
+        
+      case argparse::Action::store_const:
+      case argparse::Action::append_const:
+        return this->emit(*arg, arg->get_const(), this->opt_idx_, ev);
+        
+      case argparse::Action::store_true:
+        return this->emit(*arg, "true", this->opt_idx_, ev);
+        
+      case argparse::Action::store_false:
+        return this->emit(*arg, "false", this->opt_idx_, ev);
+        
+      case argparse::Action::count:
+      case argparse::Action::help:
+        return this->emit(*arg, argparse::StrView(), this->opt_idx_, ev);
+    }
+    
+    return false;
+  }
+  
+  bool EventCursor::sequence(argparse::Event *ev) {
+    // Same matching as ArgumentProcessor::parse_sequences.
+    const auto& seqs = this->proc_.sequences();
+    while (this->seq_left_ == 0 && this->seq_arg_ < seqs.size()) {
+      const argparse::Argument& arg = *(seqs[this->seq_arg_]);
+      const size_t remain = this->seq_total_ - this->seq_pos_;
+      const size_t min = this->proc_.seq_min(this->seq_arg_ + 1);
+      const size_t avail = (remain > min ? remain - min : 0);
+      this->seq_left_ = std::min(remain,
+                                 std::min(arg.max_nargs(),
+                                          std::max(arg.min_nargs(), avail)));
+      if (this->seq_left_ == 0) {
+        this->seq_arg_++;
+      } else if (this->seq_left_ < arg.min_nargs()) {
+        // Argument::parse throws for fewer values in parse_args.
+        return this->fail(Error::missing_value, this->opt_idx_, &arg);
+      }
+    }
+    
+    if (this->seq_left_ == 0) {
+      return this->fail(Error::extra_argument, this->opt_idx_, nullptr);
+    }
+    
+    const argparse::Argument& arg = *(seqs[this->seq_arg_]);
+    this->seq_pos_++;
+    this->seq_left_--;
+    if (this->seq_left_ == 0) {
+      this->seq_arg_++;
+    }
+    
+    this->seen_[arg.get_dest_id()] = true;
+    return this->emit(arg, this->args_[this->opt_idx_], this->opt_idx_, ev);
+  }
+  
+  size_t EventCursor::count_values(const argparse::Argument& arg,
+                                   const argparse::StrView& value) {
+    if (! arg.is_key_value()) {
+      return arg.count_items(value);
+    }
+    // Same as entries of KeyValueMap.
+    const char *eq = static_cast<const char*>(memchr(value.data(), '=',
+                                                     value.size()));
+    const size_t len = (eq ? eq - value.data() : value.size());
+    const std::pair<size_t, argparse::StrView> key(arg.get_dest_id(),
+                                                   value.substr(0, len));
+    auto less = [](const std::pair<size_t, argparse::StrView>& a,
+                   const std::pair<size_t, argparse::StrView>& b) {
+      if (a.first != b.first) {
+        return a.first < b.first;
+      }
+      const int c = memcmp(a.second.data(), b.second.data(),
+                           std::min(a.second.size(), b.second.size()));
+      return (c < 0 || (c == 0 && a.second.size() < b.second.size()));
+    };
+    auto it = std::lower_bound(this->keys_.begin(), this->keys_.end(), key,
+                               less);
+    if (it != this->keys_.end() && it->first == key.first &&
+        it->second == key.second) {
+      return 0;
+    }
+    this->keys_.insert(it, key);
+    return 1;
+  }
+  
+  bool EventCursor::emit(const argparse::Argument& arg,
+                         const argparse::StrView& value, size_t idx,
+                         argparse::Event *ev) {
+    const argparse::Action action = arg.get_action();
+    if ((action == argparse::Action::store ||
+         action == argparse::Action::append) && ! value.empty() &&
+        ! arg.check_choices(value)) {
+      return this->fail(Error::invalid_choice, idx, &arg);
+    }
+    if ((action == argparse::Action::store ||
+         action == argparse::Action::append ||
+         action == argparse::Action::store_const ||
+         action == argparse::Action::append_const) && ! value.empty() &&
+        ! arg.check_value(value, this->convert_)) {
+      return this->fail(Error::invalid_value, idx, &arg);
+    }
+    
+    if (! this->values_.empty() && action != argparse::Action::count &&
+        action != argparse::Action::help &&
+        (this->values_[arg.get_dest_id()] += this->count_values(arg, value)) >
+        this->proc_.limits().max_values) {
+      this->err_key_ = ("too many values for " + arg.get_dest() +
+                        ", limit is " +
+                        std::to_string(this->proc_.limits().max_values));
+      return this->fail(Error::limit_exceeded, idx, &arg);
+    }
+    
+    ev->dest = arg.get_dest_id();
+    ev->arg = &arg;
+    ev->value = value;
+    ev->index = idx;
+    return true;
+  }
+  
+  bool EventCursor::fail(Error err, size_t idx, const argparse::Argument *arg) {
+    this->err_ = err;
+    this->err_idx_ = idx;
+    this->err_arg_ = arg;
+    return false;
+  }
+  
+  bool EventCursor::finish() {
+    if (this->done_) {
+      return false;
+    }
+    this->done_ = true;
+    
+    // Same as ArgumentProcessor::finish, options having default are set.
+    for (const auto& it : this->proc_.options()) {
+      const argparse::Argument& arg = *(it.second);
+      const argparse::Action action = arg.get_action();
+      const bool has_default = (! arg.get_default().empty() &&
+                                (action == argparse::Action::store ||
+                                 action == argparse::Action::append ||
+                                 action == argparse::Action::count));
+      if (arg.is_required() && ! this->seen_[arg.get_dest_id()] &&
+          ! has_default && action != argparse::Action::store_true &&
+          action != argparse::Action::store_false) {
+        return this->fail(Error::missing_required, this->args_.size(),
+                          &arg);
+      }
+    }
+    
+    return false;
+  }
+  
+  void EventCursor::throw_error() const {
+    std::string key;
+    argparse::StrView val;
+    bool has_val;
+    std::vector<Var*> vars;
+    const argparse::StrView& arg = (this->err_idx_ < this->args_.size() ?
+                                    this->args_[this->err_idx_] :
+                                    argparse::StrView());
+    
+    switch (this->err_) {
+      case Error::none:
+        break;
+        
+      case Error::bad_hyphen:
+        ArgumentProcessor::split_token(arg, &key, &val, &has_val);
+        break;
+        
+      case Error::unknown_option:
+      case Error::ambiguous_option:
+        this->proc_.find_option(this->err_key_, this->err_long_);
+        break;
+        
+      case Error::duplicated_option:
+        throw argparse::exception::ParseError("duplicated option, " +
+                                              this->err_key_);
+        
+      case Error::missing_value:
+        throw argparse::exception::ParseError(
+          this->err_arg_->check_values(0, &vars));
+        
+      case Error::unexpected_value: {
+        // Let Argument::parse report it.
+        ArgumentProcessor::split_token(arg, &key, &val, &has_val);
+        this->err_arg_->parse(argparse::ArgvView(), 0, &vars, &val);
+        break;
+      }
+        
+      case Error::invalid_value:
+      case Error::invalid_choice: {
+        // Value of the option argument, "--name=value" or const value.
+        const argparse::Argument& opt = *(this->err_arg_);
+        std::string value = arg.str();
+        if (is_dash(arg)) {
+          if (ArgumentProcessor::split_token(arg, &key, &val, &has_val) ==
+              TokenType::long_option && has_val) {
+            value = val.str();
+          } else {
+            value = opt.get_const();
+          }
+        }
+        delete opt.build_var(value);
+        break;
+      }
+        
+      case Error::limit_exceeded:
+        throw argparse::exception::ParseError(this->err_key_);
+        
+      case Error::extra_argument:
+        throw argparse::exception::ParseError("too long arguments after " +
+                                              arg.str());
+        
+      case Error::missing_required: {
+        std::stringstream ss;
+        ss << "option '" << this->err_arg_->get_name() << "' is required";
+        throw argparse::exception::ParseError(ss.str());
       }
     }
+    
+    throw argparse::exception::ParseError("invalid argument: " + arg.str());
   }
 
 }
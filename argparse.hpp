@@ -32,14 +32,33 @@
 #include <memory>
 #include <vector>
 #include <map>
+#include <set>
 #include <string>
 #include <exception>
 #include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <typeinfo>
+#include <type_traits>
+#include <cstdint>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <atomic>
 
 namespace argparse_internal {
   class Values;
   class Var;
+  class VarSplit;
+  class VarKeyValue;
+  class VarAnyArray;
   class ArgumentProcessor;
+  class EventCursor;
+  class LimitCounter;
+  class BKTree;
+  struct Converter;
 }
 
 namespace argparse {
@@ -56,6 +75,8 @@ namespace argparse {
   
   
   class Parser;
+  class ParserGroup;
+  class PushParser;
   class Values;
 
   namespace exception {
@@ -77,9 +98,17 @@ namespace argparse {
     };
 
     class ParseError : public Exception {
+    private:
+      std::vector<std::string> suggestions_;
     public:
       ParseError(const std::string &errmsg);
+      // suggestions are candidates for mistyped name, e.g. "--verbose"
+      ParseError(const std::string &errmsg,
+                 const std::vector<std::string>& suggestions);
       virtual ~ParseError() throw() {}
+      const std::vector<std::string>& suggestions() const {
+        return this->suggestions_;
+      }
     };
     
     class KeyError : public Exception {
@@ -109,8 +138,24 @@ namespace argparse {
   
   enum class ArgType {
     STR,
-    INT,
+    INT,     // int
     BOOL,
+    INT32,   // int32_t, same as INT
+    INT64,   // int64_t
+    UINT64,  // uint64_t
+    DOUBLE,
+    FLOAT,
+    SIZE,      // uint64_t bytes, e.g. "4G" or "512MB"
+    DURATION,  // uint64_t nanoseconds, e.g. "250ms" or "1h30m"
+    INT_RANGES,  // IntRanges, e.g. "0-15,32-47" or "1..1000000:2"
+    IP,          // IPAddress of IPv4 or IPv6
+    IPV4,        // IPAddress, e.g. "10.0.0.1"
+    IPV6,        // IPAddress, e.g. "fe80::1"
+    CIDR,        // CidrTable, e.g. "10.0.0.0/8,fe80::/10"
+    PORTS,       // IntRanges of 0 to 65535, e.g. "80,1000-2000"
+    MAC,         // MacAddr, e.g. "aa:bb:cc:dd:ee:ff"
+    HEX,         // bytes, e.g. "0x00ff" or "00ff"
+    BASE64,      // bytes, e.g. "AP8=" with padding
   };
   
   enum class Nargs {
@@ -122,6 +167,321 @@ namespace argparse {
 
   typedef std::vector<std::string> Argv;
   
+  // Non-owning reference to (a part of) an argument string. The original
+  // string must outlive the view.
+  class StrView {
+  private:
+    const char *ptr_;
+    size_t len_;
+    
+  public:
+    StrView() : ptr_(""), len_(0) {}
+    StrView(const char *ptr, size_t len) : ptr_(ptr), len_(len) {}
+    StrView(const char *str) : ptr_(str), len_(strlen(str)) {}
+    StrView(const std::string& str) : ptr_(str.data()), len_(str.length()) {}
+    const char* data() const { return this->ptr_; }
+    size_t size() const { return this->len_; }
+    bool empty() const { return this->len_ == 0; }
+    char operator[](size_t idx) const { return this->ptr_[idx]; }
+    std::string str() const { return std::string(this->ptr_, this->len_); }
+    StrView substr(size_t pos, size_t len = std::string::npos) const {
+      pos = std::min(pos, this->len_);
+      return StrView(this->ptr_ + pos, std::min(len, this->len_ - pos));
+    }
+    bool operator==(const StrView& obj) const {
+      return (this->len_ == obj.len_ &&
+              memcmp(this->ptr_, obj.ptr_, this->len_) == 0);
+    }
+    bool operator!=(const StrView& obj) const { return !(*this == obj); }
+  };
+  
+  // Arguments as views of original strings, e.g. argv of main() or Argv.
+  typedef std::vector<StrView> ArgvView;
+  
+  // Non-owning array of arguments such as a part of argv of main(). argv()
+  // is terminated by nullptr as original argv.
+  class ArgvSpan {
+  private:
+    char* const *ptr_;
+    size_t size_;
+    static char* const EMPTY_[1];
+    
+  public:
+    ArgvSpan() : ptr_(EMPTY_), size_(0) {}
+    ArgvSpan(char* const *ptr, size_t size) : ptr_(ptr), size_(size) {}
+    size_t size() const { return this->size_; }
+    bool empty() const { return this->size_ == 0; }
+    const char* operator[](size_t idx) const { return this->ptr_[idx]; }
+    char* const* argv() const { return this->ptr_; }
+    char* const* begin() const { return this->ptr_; }
+    char* const* end() const { return this->ptr_ + this->size_; }
+  };
+  
+  // Contiguous integers of a packed Argument given by Values::to_int64s().
+  class Int64Span {
+  private:
+    const int64_t *ptr_;
+    size_t size_;
+    
+  public:
+    Int64Span() : ptr_(nullptr), size_(0) {}
+    Int64Span(const int64_t *ptr, size_t size) : ptr_(ptr), size_(size) {}
+    size_t size() const { return this->size_; }
+    bool empty() const { return this->size_ == 0; }
+    int64_t operator[](size_t idx) const { return this->ptr_[idx]; }
+    const int64_t* data() const { return this->ptr_; }
+    const int64_t* begin() const { return this->ptr_; }
+    const int64_t* end() const { return this->ptr_ + this->size_; }
+  };
+  
+  // Decoded bytes of 'hex' and 'base64' type, it refers the Values.
+  class ByteSpan {
+  private:
+    const uint8_t *ptr_;
+    size_t size_;
+    
+  public:
+    ByteSpan() : ptr_(nullptr), size_(0) {}
+    ByteSpan(const uint8_t *ptr, size_t size) : ptr_(ptr), size_(size) {}
+    size_t size() const { return this->size_; }
+    bool empty() const { return this->size_ == 0; }
+    uint8_t operator[](size_t idx) const { return this->ptr_[idx]; }
+    const uint8_t* data() const { return this->ptr_; }
+    const uint8_t* begin() const { return this->ptr_; }
+    const uint8_t* end() const { return this->ptr_ + this->size_; }
+  };
+  
+  // Integers of 'int_ranges' type kept as sorted and disjoint ranges, then
+  // a huge range costs one Range. Items are separated by ',' and an item is
+  // "N", "A-B" or "A..B" with optional step such as "A..B:2".
+  class IntRanges {
+  public:
+    struct Range {
+      int64_t first;
+      int64_t last;  // included, it's first + n * step
+      int64_t step;
+    };
+    
+    class iterator {
+    private:
+      const Range *range_;
+      const Range *end_;
+      int64_t value_;
+      
+    public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef int64_t value_type;
+      typedef ptrdiff_t difference_type;
+      typedef const int64_t* pointer;
+      typedef int64_t reference;
+      
+      iterator(const Range *range, const Range *end)
+      : range_(range), end_(end),
+        value_(range != end ? range->first : 0) {}
+      int64_t operator*() const { return this->value_; }
+      iterator& operator++() {
+        if (this->value_ == this->range_->last) {
+          if (++this->range_ != this->end_) {
+            this->value_ = this->range_->first;
+          }
+        } else {
+          this->value_ += this->range_->step;
+        }
+        return *this;
+      }
+      bool operator==(const iterator& obj) const {
+        return (this->range_ == obj.range_ &&
+                (this->range_ == this->end_ || this->value_ == obj.value_));
+      }
+      bool operator!=(const iterator& obj) const { return !(*this == obj); }
+    };
+    
+  private:
+    std::vector<Range> ranges_;
+    
+  public:
+    // Replace ranges by val. Return false with error message if invalid.
+    bool parse(const StrView& val, std::string *err);
+    // Same result as parse() without keeping ranges, and lo and hi are set
+    // to the smallest and the largest value.
+    static bool check(const StrView& val, int64_t *lo, int64_t *hi);
+    // Binary search in O(log number of ranges).
+    bool contains(int64_t v) const;
+    const std::vector<Range>& ranges() const { return this->ranges_; }
+    bool empty() const { return this->ranges_.empty(); }
+    // Iterate all values in ascending order without materializing them.
+    iterator begin() const {
+      return iterator(this->ranges_.data(),
+                      this->ranges_.data() + this->ranges_.size());
+    }
+    iterator end() const {
+      const Range *e = this->ranges_.data() + this->ranges_.size();
+      return iterator(e, e);
+    }
+  };
+  
+  // Items of an Argument with split(), given by Values::to_list(). Values
+  // of repeated options are kept in one buffer and items refer it.
+  class SplitList {
+  public:
+    class iterator {
+    private:
+      const SplitList *list_;
+      size_t idx_;
+      
+    public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef StrView value_type;
+      typedef ptrdiff_t difference_type;
+      typedef const StrView* pointer;
+      typedef StrView reference;
+      
+      iterator(const SplitList *list, size_t idx) : list_(list), idx_(idx) {}
+      StrView operator*() const { return (*this->list_)[this->idx_]; }
+      iterator& operator++() {
+        this->idx_++;
+        return *this;
+      }
+      bool operator==(const iterator& obj) const {
+        return this->idx_ == obj.idx_;
+      }
+      bool operator!=(const iterator& obj) const { return !(*this == obj); }
+    };
+    
+  private:
+    std::string buf_;  // values joined by the delimiter
+    std::vector<std::pair<size_t, size_t>> items_;  // offset and length
+    std::vector<uint64_t> choice_bits_;
+    
+  public:
+    // Split val by delim and add items, empty items are skipped.
+    void append(const StrView& val, char delim);
+    void set_choice(size_t idx);
+    
+    size_t size() const { return this->items_.size(); }
+    bool empty() const { return this->items_.empty(); }
+    StrView operator[](size_t idx) const {
+      return StrView(this->buf_.data() + this->items_[idx].first,
+                     this->items_[idx].second);
+    }
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, this->items_.size()); }
+    const std::string& str() const { return this->buf_; }
+    // True if an item is choices[idx] of the Argument.
+    bool has_choice(size_t idx) const {
+      return (idx / 64 < this->choice_bits_.size() &&
+              (this->choice_bits_[idx / 64] >> (idx % 64)) & 1);
+    }
+    // Bitset of choice indexes, bit (idx % 64) of word (idx / 64).
+    const std::vector<uint64_t>& choice_bits() const {
+      return this->choice_bits_;
+    }
+  };
+  
+  // IPv4 or IPv6 address in network byte order. IPv4 is kept as IPv4-mapped
+  // IPv6 address (::ffff:a.b.c.d), then both can be compared as 16 bytes.
+  struct IPAddress {
+    uint8_t bytes[16];
+    
+    bool is_v4() const;
+    // IPv4 address in host byte order, 0 if not IPv4.
+    uint32_t v4() const;
+    bool operator==(const IPAddress& obj) const {
+      return memcmp(this->bytes, obj.bytes, sizeof(this->bytes)) == 0;
+    }
+    bool operator<(const IPAddress& obj) const {
+      return memcmp(this->bytes, obj.bytes, sizeof(this->bytes)) < 0;
+    }
+    
+    // Return false if val is invalid. IPv4 is dotted decimal without leading
+    // zero, and IPv6 allows "::" and IPv4 at tail.
+    static bool parse_v4(const StrView& val, IPAddress *out);
+    static bool parse_v6(const StrView& val, IPAddress *out);
+    static bool parse(const StrView& val, IPAddress *out);
+  };
+  
+  // MAC address such as "aa:bb:cc:dd:ee:ff" or "AA-BB-CC-DD-EE-FF".
+  struct MacAddr {
+    uint8_t bytes[6];
+    bool operator==(const MacAddr& obj) const {
+      return memcmp(this->bytes, obj.bytes, sizeof(this->bytes)) == 0;
+    }
+    static bool parse(const StrView& val, MacAddr *out);
+  };
+  
+  // CIDR blocks of 'cidr' type and repeated options in given order, and a
+  // sorted table of merged address intervals for contains() in O(log n).
+  class CidrTable {
+  public:
+    struct Cidr {
+      IPAddress addr;  // host bits are cleared
+      uint8_t length;  // prefix length as given, up to 32 for IPv4
+    };
+    
+  private:
+    std::vector<Cidr> cidrs_;
+    std::vector<std::pair<IPAddress, IPAddress>> table_;  // first and last
+    
+  public:
+    // Add comma separated CIDR blocks, an address without length is a host.
+    // Return false with error message if invalid, and nothing is added.
+    bool add(const StrView& val, std::string *err);
+    // Same check as add() without adding blocks.
+    static bool check(const StrView& val, std::string *err);
+    bool contains(const IPAddress& addr) const;
+    const std::vector<Cidr>& cidrs() const { return this->cidrs_; }
+    // Number of disjoint intervals after merge.
+    size_t intervals() const { return this->table_.size(); }
+  };
+  
+  // Policy for a duplicated key of Argument::key_value().
+  enum class DupKey {
+    last_wins,
+    first_wins,
+    error,  // ParseError
+  };
+  
+  // "key=value" items of an Argument with key_value(), given by
+  // Values::get_map(). It's a flat open addressing hash table of views
+  // into the arguments kept by the map, and entries are in order of keys
+  // given first.
+  class KeyValueMap {
+  public:
+    struct Entry {
+      StrView key;
+      StrView value;
+    };
+    
+  private:
+    std::deque<std::string> raw_;  // elements are not moved by push_back
+    std::vector<Entry> entries_;
+    std::vector<uint64_t> hashes_;
+    std::vector<uint32_t> slots_;  // index of entries_ + 1, 0 if empty
+    
+    static uint64_t hash(const StrView& key);
+    // Slot of key, or an empty slot for it.
+    size_t probe(const StrView& key, uint64_t h) const;
+    void rehash(size_t capacity);
+    
+  public:
+    KeyValueMap() = default;
+    KeyValueMap(const KeyValueMap& obj) = delete;
+    // Add "key=value" of an argument. Return false with error message if
+    // it's invalid or a duplicated key for DupKey::error.
+    bool insert(const StrView& item, DupKey dup, std::string *err);
+    
+    // Entry of key in O(1), nullptr if not found.
+    const Entry* find(const StrView& key) const;
+    size_t size() const { return this->entries_.size(); }
+    bool empty() const { return this->entries_.empty(); }
+    std::vector<Entry>::const_iterator begin() const {
+      return this->entries_.begin();
+    }
+    std::vector<Entry>::const_iterator end() const {
+      return this->entries_.end();
+    }
+  };
+  
   class Argument {
   private:
     ArgFormat arg_format_;
@@ -132,16 +492,26 @@ namespace argparse {
     std::string const_;
     std::string default_;
     ArgType type_;
-    std::string choices_;
+    std::vector<std::string> choices_;
+    std::vector<size_t> choice_order_;  // indexes of choices_ sorted by value
     bool required_;
+    bool nonfinite_;
+    bool packed_;
+    char delim_;  // '\0' if not split
+    bool key_value_;
+    DupKey dup_key_;
+    size_t bytes_;  // 0 if any length
     std::string help_;
     std::string metavar_;
     std::string dest_;
     Action action_;
+    std::shared_ptr<argparse_internal::Converter> converter_;
+    size_t dest_id_;
     argparse_internal::ArgumentProcessor *proc_;
     
-    size_t parse_append(const Argv& args, size_t idx,
-                        std::vector<argparse_internal::Var*> *opt_list) const;
+    size_t parse_append(const ArgvView& args, size_t idx,
+                        std::vector<argparse_internal::Var*> *opt_list,
+                        const StrView *inline_val) const;
     static void handle_count(std::vector<argparse_internal::Var*> *opt_list);
     static std::string extract_opt_name(const std::string& name);
     std::string build_usage(const std::string& arg_name) const;
@@ -156,8 +526,17 @@ namespace argparse {
     // can be called only once and should be called by Parser::AddArgument
     const std::string& set_name(const std::string &v_name);
     ArgFormat arg_format() const { return this->arg_format_; }
+    // inline_val is "value" of "--name=value" and nullptr if not given.
+    size_t parse(const ArgvView& args, size_t idx,
+                 std::vector<argparse_internal::Var*> *opt_list,
+                 const StrView *inline_val = nullptr) const;
     size_t parse(const Argv& args, size_t idx,
                  std::vector<argparse_internal::Var*> *opt_list) const;
+    // Check number of values given by command line (argc) and add a value
+    // to opt_list for nargs '?' if needed. Return error message if invalid.
+    std::string check_values(size_t argc,
+                             std::vector<argparse_internal::Var*> *opt_list)
+      const;
     
     // can set secondary option name such as first "-s" and second "--sum"
     Argument& name(const std::string& v_name);
@@ -168,9 +547,37 @@ namespace argparse {
     Argument& set_default(const std::string& v_default);
     Argument& type(ArgType v_type);
     Argument& type(const std::string& v_type);
-    // TODO: implement choices (#1)
-    // Argument& choices(const std::string& v_choices);
+    // User type converted by conv, e.g. type<Duration>(parse_duration).
+    // conv takes const StrView& (or const std::string&) and throws an
+    // exception for invalid value. Values of a dest are kept in one
+    // std::vector<T>, given by Values::get<T>() for each value or by
+    // Values::get<std::vector<T>>() for all. Only for store and append, and
+    // nargs "?" needs const. T can't be bool as std::vector<bool> is packed.
+    template <typename T, typename F>
+    Argument& type(const F& conv);
+    // Value must be one of v_choices, and Values::to_index() returns its
+    // position in v_choices. Only for 'str' type of store and append.
+    Argument& choices(const std::vector<std::string>& v_choices);
     Argument& required(bool req);
+    // Allow "nan", "inf" and "infinity" for 'double' and 'float' type, they
+    // are invalid by default.
+    Argument& nonfinite(bool allow);
+    // Store integers in one contiguous array instead of a Var for each
+    // value, and Values::to_int64s() gives them. Only for 'int', 'int32'
+    // and 'int64' type of store and append, and values are not available
+    // as string.
+    Argument& packed(bool pack);
+    // Split a value by delim into items of SplitList given by
+    // Values::to_list(), and items of repeated options are merged. Each item
+    // must be one of choices if set, and counts as a value of size() and
+    // Limits. Only for 'str' type of store and append with one argument.
+    Argument& split(char delim);
+    // Collect "key=value" of repeated options into KeyValueMap given by
+    // Values::get_map(). An entry counts as a value of size() and Limits.
+    // Only for 'str' type of store and append with one argument.
+    Argument& key_value(DupKey dup = DupKey::last_wins);
+    // Decoded length of 'hex' and 'base64' type must be n bytes.
+    Argument& bytes(size_t n);
     Argument& help(const std::string& v_help);
     Argument& metavar(const std::string& v_metavar);
     Argument& dest(const std::string& v_dest);
@@ -189,7 +596,52 @@ namespace argparse {
     const std::string& get_default() const { return this->default_; }
     ArgType get_type() const { return this->type_; }
     bool is_required() const { return this->required_; }
+    // Index of dest in the Parser, it's set by ArgumentProcessor::freeze().
+    size_t get_dest_id() const { return this->dest_id_; }
+    void set_dest_id(size_t id) { this->dest_id_ = id; }
     const std::string& get_help() const { return this->help_; }
+    const std::vector<std::string>& get_choices() const {
+      return this->choices_;
+    }
+    // Index of val in choices by binary search, NO_CHOICE if not found.
+    static const size_t NO_CHOICE = static_cast<size_t>(-1);
+    size_t find_choice(const StrView& val) const;
+    // Append choices starting with prefix in sorted order.
+    void complete_choice(const std::string& prefix,
+                         std::vector<std::string> *out) const;
+    bool is_packed() const { return this->packed_; }
+    bool is_split() const { return this->delim_ != '\0'; }
+    bool is_key_value() const { return this->key_value_; }
+    // Var::build_var with type, converter and choices of the Argument.
+    argparse_internal::Var* build_var(const StrView& val) const;
+    // Add a Var of val to opt_list, or add val to the Var if packed or split.
+    void add_value(const StrView& val,
+                   std::vector<argparse_internal::Var*> *opt_list) const;
+    // Split val and add items to var with choices.
+    void split_into(argparse_internal::VarSplit *var, const StrView& val) const;
+    void convert_into(argparse_internal::VarAnyArray *var,
+                      const StrView& val) const;
+    void insert_into(argparse_internal::VarKeyValue *var,
+                     const StrView& val) const;
+    // Same check as build_var without keeping a Var. A converter function
+    // is not called if convert is false.
+    bool check_value(const StrView& val, bool convert = true) const;
+    // ParseError if val is not one of choices.
+    void check_choice(const StrView& val) const;
+    // True if val, or each item of val if split, is one of choices.
+    bool check_choices(const StrView& val) const;
+    // Number of values in val counted by Values::size(), items of split and
+    // blocks of 'cidr' type.
+    size_t count_items(const StrView& val) const;
+    // ParseError if val is nan or inf and nonfinite() is not allowed.
+    void check_nonfinite(const StrView& val) const;
+    bool is_float() const {
+      return (this->type_ == ArgType::DOUBLE || this->type_ == ArgType::FLOAT);
+    }
+    // Range of number of values from command line.
+    static const size_t NARGS_UNLIMITED = static_cast<size_t>(-1);
+    size_t min_nargs() const;
+    size_t max_nargs() const;
     
     void check_consistency() const;
     std::string usage() const;
@@ -197,12 +649,110 @@ namespace argparse {
   };
   
   
+  // Limits of command line for untrusted input, 0 is unlimited. They are
+  // checked before parsing with no allocation.
+  struct Limits {
+    size_t max_args;     // number of arguments including program name
+    size_t max_bytes;    // total length of arguments
+    size_t max_values;   // number of values for a dest
+    size_t max_cluster;  // number of letters in "-abc"
+    Limits() : max_args(0), max_bytes(0), max_values(0), max_cluster(0) {}
+  };
+  
+  // Kind of error found by Parser::validate().
+  enum class ErrorCode {
+    none,
+    bad_hyphen,          // "---name"
+    unknown_option,
+    ambiguous_option,    // abbreviation matching several options
+    duplicated_option,
+    missing_value,       // less values than nargs
+    unexpected_value,    // "--name=value" for an option without value
+    invalid_value,       // type mismatch
+    invalid_choice,      // not in choices
+    extra_argument,      // too many sequence arguments
+    missing_required,
+    limit_exceeded,      // see Limits
+  };
+  
+  // Result of Parser::validate(). index is the argument causing the error
+  // (args.size() for missing_required) and arg is the Argument if known.
+  struct ParseStatus {
+    ErrorCode code;
+    size_t index;
+    const Argument *arg;
+    bool ok() const { return this->code == ErrorCode::none; }
+  };
+  
+  // An option or a sequence argument found in command line. It's reported
+  // in order of arguments by Parser::parse_events().
+  struct Event {
+    size_t dest;          // same as Parser::dest_id() of arg->get_dest()
+    const Argument *arg;
+    // A value given by command line, const value of store_const, "true" or
+    // "false" of store_true/false, or empty for count and help. It refers
+    // the original argument or the Argument.
+    StrView value;
+    size_t index;         // index of the value (or the option) in args
+  };
+  // Return false to stop parsing.
+  typedef std::function<bool(const Event&)> EventHandler;
+  
+  // Lazy range of Events returned by Parser::events(). Next Event is parsed
+  // when the iterator is advanced, and ParseError is thrown there. Events
+  // are not allocated, the iterator refers an Event in the range.
+  class EventRange {
+  private:
+    struct State;
+    std::unique_ptr<State> state_;
+    EventRange(State *state);
+    void advance();
+    friend class Parser;
+    
+  public:
+    class iterator {
+    private:
+      EventRange *range_;  // nullptr for end
+      
+    public:
+      typedef std::input_iterator_tag iterator_category;
+      typedef Event value_type;
+      typedef ptrdiff_t difference_type;
+      typedef const Event* pointer;
+      typedef const Event& reference;
+      
+      iterator(EventRange *range) : range_(range) {}
+      const Event& operator*() const;
+      const Event* operator->() const { return &(**this); }
+      iterator& operator++() {
+        this->range_->advance();
+        return *this;
+      }
+      bool operator==(const iterator& obj) const;
+      bool operator!=(const iterator& obj) const { return !(*this == obj); }
+    };
+    
+    EventRange(EventRange&& obj);
+    ~EventRange();
+    EventRange(const EventRange& obj) = delete;
+    
+    // Can be called once, the range is consumed by iteration.
+    iterator begin();
+    iterator end() { return iterator(nullptr); }
+    // Same as return value of Parser::parse_events() after iteration.
+    size_t position() const;
+  };
+  
   class Parser {
   private:
     std::string prog_name_;
     std::string version_;
     argparse_internal::ArgumentProcessor *proc_;
     std::ostream *output_;
+    Values parse(const ArgvView& args, const ArgvSpan *rest,
+                 ArgvView *unknown) const;
+    friend class ParserGroup;
+    friend class PushParser;
     
   public:
     Parser(const std::string &prog_name);
@@ -213,9 +763,49 @@ namespace argparse {
     Argument& add_argument(const std::string& name,
                            const std::string& name2="");
     Values parse_args(const Argv& args) const;
+    // Arguments after "--" are not copied and Values::rest() refers argv.
     Values parse_args(int argc, char *argv[]) const;
+    // Unknown options and extra arguments are stored into unknown in order
+    // as views of args instead of ParseError. unknown starts with args[0]
+    // so that it can be passed to parse_known_args of another Parser.
+    Values parse_known_args(const Argv& args, ArgvView *unknown) const;
+    Values parse_known_args(int argc, char *argv[], ArgvView *unknown) const;
+    Values parse_known_args(const ArgvView& args, ArgvView *unknown) const;
     void usage() const;
     void help() const;
+    // output a completion script for "bash", "zsh" or "fish" which calls
+    // hidden mode "prog __complete <cword> <words...>"
+    void completion_script(const std::string& shell) const;
+    // accept unambiguous prefix of long option, e.g. --verb for --verbose
+    void allow_abbrev(bool allow);
+    // ParseError (limit_exceeded for validate) if args are over limits.
+    void set_limits(const Limits& limits);
+    
+    // Report values to handler one by one in order of args without building
+    // Values. Default values are not reported. Checks are same as
+    // parse_args, but missing required options and extra arguments are
+    // found after all events. Return index of the first argument not parsed:
+    // args.size(), index after "--" or where handler stopped.
+    size_t parse_events(const ArgvView& args,
+                        const EventHandler& handler) const;
+    size_t parse_events(int argc, char *argv[],
+                        const EventHandler& handler) const;
+    // Lazy version of parse_events, args must outlive EventRange. e.g.
+    //   for (const auto& ev : psr.events(argc, argv)) { ... }
+    EventRange events(const ArgvView& args) const;
+    EventRange events(int argc, char *argv[]) const;
+    // Check args as parse_args without building values and without
+    // exception for invalid args. Help option is not handled. Values of a
+    // type() with a converter function are not converted, then errors of
+    // the function are found only by parse_args and parse_events.
+    ParseStatus validate(const ArgvView& args) const;
+    ParseStatus validate(const Argv& args) const;
+    ParseStatus validate(int argc, char *argv[]) const;
+    // Same message as ParseError of parse_args, empty if args are valid.
+    // It parses args again, then use it only for invalid args.
+    std::string error_message(const ArgvView& args) const;
+    // Small integer to identify dest in Event, KeyError if not found.
+    size_t dest_id(const std::string& dest) const;
     
     void set_output(std::ostream *output);
   };
@@ -226,22 +816,44 @@ namespace argparse {
   std::vector<argparse_internal::Var*>*> {
   private:
     bool help_mode_;
+    bool complete_mode_;
+    size_t max_values_;
+    ArgvSpan rest_;
+    std::vector<char*> rest_buf_;
+    std::vector<std::string> rest_str_;
 
   public:
-    VarMap() : help_mode_(false) {};
-    ~VarMap() {}
+    VarMap() : help_mode_(false), complete_mode_(false), max_values_(0) {};
+    ~VarMap();
+    VarMap(const VarMap& obj) = delete;
+    void set_rest(const ArgvSpan& rest) { this->rest_ = rest; }
+    void set_rest(const ArgvView& args, size_t idx);
+    void set_rest(const std::vector<std::string>& args);  // copy arguments
+    const ArgvSpan& rest() const { return this->rest_; }
     void set_help_mode(bool help_mode) { this->help_mode_ = help_mode; }
     bool is_help_mode() const { return this->help_mode_; }
+    void set_complete_mode(bool mode) { this->complete_mode_ = mode; }
+    bool is_complete_mode() const { return this->complete_mode_; }
+    // Limits::max_values, ParseError by check_values() if vars is over it.
+    void set_max_values(size_t max) { this->max_values_ = max; }
+    void check_values(const std::string& dest,
+                      const std::vector<argparse_internal::Var*>& vars) const;
+    // Number of values in vars, packed values are counted one by one.
+    static size_t count_values(const std::vector<argparse_internal::Var*>&
+                               vars);
   };
   
   class Values {
   private:
     std::shared_ptr<VarMap> varmap_;
-    static const std::vector<argparse_internal::Var*>&
-      get_var_arr(const VarMap& varmap, const std::string& key);
-    static const argparse_internal::Var& get_var(const VarMap& varmap,
-                                                 const std::string& key,
-                                                 size_t idx);
+    std::string prefix_;  // "db.pool." for subtree("db.pool")
+    const std::vector<argparse_internal::Var*>&
+      get_var_arr(const std::string& key) const;
+    const argparse_internal::Var& get_var(const std::string& key,
+                                          size_t idx) const;
+    // Var having value idx and position of the value in the Var.
+    const argparse_internal::Var& get_var(const std::string& key, size_t idx,
+                                          size_t *pos) const;
     
   public:
     Values(std::shared_ptr<VarMap> varmap);
@@ -251,6 +863,45 @@ namespace argparse {
     const std::string& operator[](const std::string& key) const;
     const std::string& get(const std::string& dest, size_t idx=0) const;
     int to_int(const std::string& dest, size_t idx=0) const;
+    // TypeError if the value can not be represented.
+    int64_t to_int64(const std::string& dest, size_t idx=0) const;
+    uint64_t to_uint64(const std::string& dest, size_t idx=0) const;
+    double to_double(const std::string& dest, size_t idx=0) const;
+    // Value of 'duration' type. TypeError if it's over range of nanoseconds.
+    std::chrono::nanoseconds to_duration(const std::string& dest,
+                                         size_t idx=0) const;
+    // All values of dest in a contiguous array, e.g. for nargs("+").
+    std::vector<double> to_doubles(const std::string& dest) const;
+    // Values of a packed Argument, it refers the Values.
+    Int64Span to_int64s(const std::string& dest) const;
+    // Items of an Argument with split().
+    const SplitList& to_list(const std::string& dest) const;
+    // Items of an Argument with key_value().
+    const KeyValueMap& get_map(const std::string& dest) const;
+    // Value of 'int_ranges' and 'ports' type.
+    const IntRanges& to_ranges(const std::string& dest, size_t idx=0) const;
+    // Value of 'ip', 'ipv4' and 'ipv6' type.
+    const IPAddress& to_ip(const std::string& dest, size_t idx=0) const;
+    // All addresses of dest in a contiguous array.
+    std::vector<IPAddress> to_ips(const std::string& dest) const;
+    // All blocks of 'cidr' type, repeated options are merged.
+    const CidrTable& to_cidrs(const std::string& dest) const;
+    // Decoded bytes of 'hex' and 'base64' type.
+    ByteSpan to_bytes(const std::string& dest, size_t idx=0) const;
+    // Position of the value in choices of the Argument.
+    size_t to_index(const std::string& dest, size_t idx=0) const;
+    template <typename E>
+    E as_enum(const std::string& dest, size_t idx=0) const {
+      return static_cast<E>(this->to_index(dest, idx));
+    }
+    // Typed value, e.g. get<int>() for 'int' type, get<std::string>() for
+    // 'str' type and get<T>() for type<T>(). TypeError if T is not matched.
+    template <typename T>
+    const T& get(const std::string& dest, size_t idx=0) const {
+      return *static_cast<const T*>(this->get_ptr(dest, idx, typeid(T)));
+    }
+    const void* get_ptr(const std::string& dest, size_t idx,
+                        const std::type_info& type) const;
     const std::string& to_str(const std::string& dest, size_t idx=0) const;
     
 
@@ -258,7 +909,102 @@ namespace argparse {
     bool is_true(const std::string& dest) const;
     bool is_set(const std::string& dest) const;
     
+    // View of dests under a dotted prefix, e.g. sub["size"] of
+    // subtree("db.pool") is "db.pool.size". It shares values.
+    Values subtree(const std::string& prefix) const;
+    // Dests set in the view, relative to the prefix and in sorted order.
+    std::vector<std::string> keys() const;
+    
     bool is_help_mode() const;
+    bool is_complete_mode() const;
+    // Arguments after "--" which are not parsed. If parsed from Argv, it
+    // refers strings of the Argv and the Argv must outlive Values.
+    const ArgvSpan& rest() const;
+  };
+  
+  // Parsers of several components sharing one command line. Each argument
+  // is scanned once, looked up in a merged index of all options and routed
+  // to the Parser owning it. Help options are shared by all Parsers.
+  class ParserGroup {
+  private:
+    struct Route {
+      size_t owner;  // index of parsers_, NO_OWNER for help options
+      const Argument *arg;
+    };
+    struct Index;  // merged options, abbreviations and limits of parsers_
+    static const size_t NO_OWNER = static_cast<size_t>(-1);
+    std::vector<const Parser*> parsers_;
+    // The index is rebuilt by freeze() at parse when an attached Parser is
+    // configured again, and guarded as ArgumentProcessor::freeze().
+    mutable std::unique_ptr<Index> index_;
+    mutable std::mutex freeze_mutex_;
+    mutable std::atomic<size_t> generation_;
+    mutable std::atomic<bool> bktree_built_;
+    
+    size_t generation() const;
+    void build() const;
+    void freeze() const;
+    const argparse_internal::BKTree& suggestion_tree() const;
+    const Route* resolve(const std::string& key, bool is_long,
+                         bool *ambiguous) const;
+    size_t route(const ArgvView& args, size_t idx, const std::string& key,
+                 bool is_long,
+                 const std::vector<std::shared_ptr<VarMap> >& maps,
+                 const StrView *inline_val) const;
+    std::vector<Values> parse(const ArgvView& args,
+                              const ArgvSpan *rest) const;
+    
+  public:
+    ParserGroup();
+    ~ParserGroup();
+    ParserGroup(const ParserGroup& obj) = delete;
+    
+    // Parser must outlive ParserGroup. ConfigureError if an option name or
+    // sequence arguments are already defined by an attached Parser, and psr
+    // is not attached. Options added after attach() are found at parse.
+    void attach(const Parser& psr);
+    // Return Values of each Parser in order of attach().
+    std::vector<Values> parse_args(const Argv& args) const;
+    std::vector<Values> parse_args(int argc, char *argv[]) const;
+    // Usage and help of all Parsers as one command, written to output of
+    // the first Parser. Help options print it once.
+    void usage() const;
+    void help() const;
+  };
+  
+  // Parser accepting arguments one by one, e.g. from a pipe. An option and
+  // its values are converted and checked when they arrive. Sequence
+  // arguments are matched in finish() because "SRC [SRC ...] DST" requires
+  // number of all of them.
+  class PushParser {
+  private:
+    struct Pending {
+      const Argument *arg;
+      std::vector<argparse_internal::Var*> *vars;
+      size_t count;  // number of values given
+    };
+    const Parser& psr_;
+    std::shared_ptr<VarMap> varmap_;
+    std::vector<Pending> pending_;  // options waiting values, e.g. "-ab"
+    std::vector<std::string> seq_;
+    std::vector<std::string> rest_;
+    bool passthrough_;  // after "--"
+    std::unique_ptr<argparse_internal::LimitCounter> counter_;
+    
+    void open_option(const std::string& key, bool is_long,
+                     const StrView *inline_val);
+    void close_options();
+    
+  public:
+    // Parser must not be modified while parsing.
+    PushParser(const Parser& psr);
+    ~PushParser();
+    PushParser(const PushParser& obj) = delete;
+    
+    // token is an argument without program name. ParseError is thrown as
+    // soon as the token is invalid, and then PushParser can not be used.
+    void feed(const std::string& token);
+    Values finish();
   };
 }
 
@@ -275,12 +1021,12 @@ namespace argparse_internal {
   class Var {
   private:
     bool valid_;
-    std::stringstream err_;
+    std::string err_;
     
   protected:
-    std::stringstream& err_stream() {
+    void set_err(const std::string& err) {
       this->valid_ = false;
-      return this->err_;
+      this->err_ = err;
     }
     
   public:
@@ -292,18 +1038,88 @@ namespace argparse_internal {
     virtual int to_i() const {
       throw argparse::exception::TypeError("not has an integer value");
     }
+    virtual int64_t to_i64() const {
+      throw argparse::exception::TypeError("not has an int64 value");
+    }
+    virtual uint64_t to_u64() const {
+      throw argparse::exception::TypeError("not has an uint64 value");
+    }
+    virtual double to_d() const {
+      throw argparse::exception::TypeError("not has a double value");
+    }
+    // Number of values in the Var, it's more than 1 for packed values.
+    virtual size_t count() const { return 1; }
     virtual bool is_true() const {
       throw argparse::exception::TypeError("not has a boolean value");
     }
+    virtual size_t to_index() const {
+      throw argparse::exception::TypeError("not has a choice");
+    }
+    // Pointer to the value if it's stored as type.
+    virtual const void* get(const std::type_info& type) const {
+      throw argparse::exception::TypeError(std::string("not has a value of ") +
+                                           type.name());
+    }
+    // Value at pos of a Var holding several values such as VarAnyArray,
+    // pos is always 0 for others.
+    virtual const std::string& str_at(size_t pos) const {
+      (void)pos;
+      return this->to_s();
+    }
+    virtual size_t index_at(size_t pos) const {
+      (void)pos;
+      return this->to_index();
+    }
+    virtual const void* get_at(const std::type_info& type, size_t pos) const {
+      (void)pos;
+      return this->get(type);
+    }
     virtual bool is_null() const {
       return false;
     }
     
     bool is_valid() const { return this->valid_; }
-    const std::string err() const {
-      return this->err_.str();
-    }
-    static Var* build_var(const std::string& val, argparse::ArgType type);
+    const std::string& err() const { return this->err_; }
+    static Var* build_var(const argparse::StrView& val, argparse::ArgType type);
+    // Same check as build_var without building a Var.
+    static bool check(const argparse::StrView& val, argparse::ArgType type);
+    
+    // Parse an integer without locale and allocation. It's decimal, or hex
+    // with "0x", octal with "0o" or "0", and binary with "0b" after sign.
+    enum class NumResult { ok, invalid, out_of_range };
+    static NumResult parse_int(const argparse::StrView& val, int64_t min,
+                               int64_t max, int64_t *out);
+    static NumResult parse_uint(const argparse::StrView& val, uint64_t max,
+                                uint64_t *out);
+    // Parse a floating point number in decimal with optional exponent, or
+    // "nan", "inf" and "infinity". It's out_of_range if the number is too
+    // large for double, or for float if single is true.
+    static NumResult parse_double(const argparse::StrView& val, bool single,
+                                  double *out);
+    // Size in bytes with optional unit. K, M, G, T and P are 1024^n as
+    // coreutils, "KB" etc. are 1000^n and "KiB" etc. are 1024^n. "B" is
+    // allowed for bytes, and a fraction such as "1.5G" is rounded down.
+    // Units are case insensitive.
+    static NumResult parse_size(const argparse::StrView& val, uint64_t *out);
+    // Duration in nanoseconds as a sequence of number and unit, e.g.
+    // "1h30m" or "2.5s". Units are ns, us, ms, s, m, h and d, and "0" is
+    // allowed without unit.
+    static NumResult parse_duration(const argparse::StrView& val,
+                                    uint64_t *out);
+    // True if val is nan or inf accepted by parse_double.
+    static bool is_nonfinite(const argparse::StrView& val);
+    // Return false if val is invalid. Hex allows "0x" prefix and needs even
+    // digits, and base64 needs padding and zero unused bits.
+    static bool decode_hex(const argparse::StrView& val,
+                           std::vector<uint8_t> *out);
+    static bool decode_base64(const argparse::StrView& val,
+                              std::vector<uint8_t> *out);
+    // Same result as decode_hex and decode_base64 without decoding.
+    static bool check_hex(const argparse::StrView& val);
+    static bool check_base64(const argparse::StrView& val);
+    // Length of decoded bytes of HEX or BASE64 without decoding.
+    static size_t decoded_size(const argparse::StrView& val,
+                               argparse::ArgType type);
   };
   
   class VarInt : public Var {
@@ -312,16 +1128,62 @@ namespace argparse_internal {
     std::string str_;
     
   public:
-    VarInt(const std::string& val);
+    VarInt(const argparse::StrView& val);
     ~VarInt() = default;
     const std::string& to_s() const override { return this->str_; }
     int to_i() const override { return this->value_; }
+    int64_t to_i64() const override { return this->value_; }
+    uint64_t to_u64() const override {
+      return (this->value_ >= 0 ? this->value_ : Var::to_u64());
+    }
+    double to_d() const override { return this->value_; }
+    const void* get(const std::type_info& type) const override {
+      return (type == typeid(int) ? &this->value_ : Var::get(type));
+    }
     
     void increment() {
       this->value_++;
-      std::stringstream ss;
-      ss << this->value_;
-      this->str_ = ss.str();
+      this->str_ = std::to_string(this->value_);
+    }
+  };
+  
+  class VarInt64 : public Var {
+  private:
+    int64_t value_;
+    std::string str_;
+    
+  public:
+    VarInt64(const argparse::StrView& val);
+    ~VarInt64() = default;
+    const std::string& to_s() const override { return this->str_; }
+    int to_i() const override;
+    int64_t to_i64() const override { return this->value_; }
+    uint64_t to_u64() const override {
+      return (this->value_ >= 0 ? this->value_ : Var::to_u64());
+    }
+    double to_d() const override { return this->value_; }
+    const void* get(const std::type_info& type) const override {
+      return (type == typeid(int64_t) ? &this->value_ : Var::get(type));
+    }
+  };
+  
+  class VarUint64 : public Var {
+  private:
+    uint64_t value_;
+    std::string str_;
+    
+  public:
+    // type is UINT64, SIZE or DURATION.
+    VarUint64(const argparse::StrView& val,
+              argparse::ArgType type = argparse::ArgType::UINT64);
+    ~VarUint64() = default;
+    const std::string& to_s() const override { return this->str_; }
+    int to_i() const override;
+    int64_t to_i64() const override;
+    uint64_t to_u64() const override { return this->value_; }
+    double to_d() const override { return this->value_; }
+    const void* get(const std::type_info& type) const override {
+      return (type == typeid(uint64_t) ? &this->value_ : Var::get(type));
     }
   };
 
@@ -333,8 +1195,192 @@ namespace argparse_internal {
     VarStr(const std::string& value) : value_(value) {}
     ~VarStr() = default;
     const std::string& to_s() const override { return this->value_; }
+    const void* get(const std::type_info& type) const override {
+      return (type == typeid(std::string) ? &this->value_ : Var::get(type));
+    }
   };
 
+  class VarChoice : public VarStr {
+  private:
+    size_t index_;
+    
+  public:
+    VarChoice(const std::string& value, size_t index)
+      : VarStr(value), index_(index) {}
+    ~VarChoice() = default;
+    size_t to_index() const override { return this->index_; }
+  };
+
+  // All values of a packed Argument.
+  class VarIntArray : public Var {
+  private:
+    std::vector<int64_t> values_;
+    argparse::ArgType type_;
+    
+  public:
+    VarIntArray(argparse::ArgType type) : type_(type) {}
+    ~VarIntArray() = default;
+    // ParseError if val is invalid for the type.
+    void push(const argparse::StrView& val);
+    // Drop values after n, for rollback of an error.
+    void resize(size_t n) { this->values_.resize(n); }
+    size_t count() const override { return this->values_.size(); }
+    const std::vector<int64_t>& values() const { return this->values_; }
+    const void* get(const std::type_info& type) const override {
+      return (type == typeid(std::vector<int64_t>) ? &this->values_ :
+              Var::get(type));
+    }
+  };
+  
+  // All values of an Argument with split().
+  class VarSplit : public Var {
+  private:
+    argparse::SplitList value_;
+    
+  public:
+    VarSplit() = default;
+    ~VarSplit() = default;
+    argparse::SplitList& list() { return this->value_; }
+    const std::string& to_s() const override { return this->value_.str(); }
+    // Items count as values for Limits::max_values.
+    size_t count() const override { return this->value_.size(); }
+    const void* get(const std::type_info& type) const override {
+      return (type == typeid(argparse::SplitList) ? &this->value_ :
+              Var::get(type));
+    }
+  };
+  
+  // All "key=value" of an Argument with key_value().
+  class VarKeyValue : public Var {
+  private:
+    argparse::KeyValueMap value_;
+    
+  public:
+    VarKeyValue() = default;
+    ~VarKeyValue() = default;
+    argparse::KeyValueMap& map() { return this->value_; }
+    // Entries count as values for Limits::max_values.
+    size_t count() const override { return this->value_.size(); }
+    const void* get(const std::type_info& type) const override {
+      return (type == typeid(argparse::KeyValueMap) ? &this->value_ :
+              Var::get(type));
+    }
+  };
+  
+  class VarIP : public Var {
+  private:
+    argparse::IPAddress value_;
+    std::string str_;
+    
+  public:
+    // type is IP, IPV4 or IPV6.
+    VarIP(const argparse::StrView& val, argparse::ArgType type);
+    ~VarIP() = default;
+    const std::string& to_s() const override { return this->str_; }
+    const void* get(const std::type_info& type) const override {
+      return (type == typeid(argparse::IPAddress) ? &this->value_ :
+              Var::get(type));
+    }
+  };
+  
+  class VarBytes : public Var {
+  private:
+    std::vector<uint8_t> value_;
+    std::string str_;
+    
+  public:
+    // type is HEX or BASE64.
+    VarBytes(const argparse::StrView& val, argparse::ArgType type);
+    ~VarBytes() = default;
+    const std::string& to_s() const override { return this->str_; }
+    const void* get(const std::type_info& type) const override {
+      return (type == typeid(std::vector<uint8_t>) ? &this->value_ :
+              Var::get(type));
+    }
+  };
+  
+  class VarMac : public Var {
+  private:
+    argparse::MacAddr value_;
+    std::string str_;
+    
+  public:
+    VarMac(const argparse::StrView& val);
+    ~VarMac() = default;
+    const std::string& to_s() const override { return this->str_; }
+    const void* get(const std::type_info& type) const override {
+      return (type == typeid(argparse::MacAddr) ? &this->value_ :
+              Var::get(type));
+    }
+  };
+  
+  // All CIDR blocks of an Argument, values of repeated options are added.
+  class VarCidr : public Var {
+  private:
+    argparse::CidrTable value_;
+    std::string str_;  // values joined by ','
+    
+  public:
+    VarCidr(const argparse::StrView& val);
+    ~VarCidr() = default;
+    // ParseError if val is invalid.
+    void add(const argparse::StrView& val);
+    const std::string& to_s() const override { return this->str_; }
+    // Blocks count as values for Limits::max_values.
+    size_t count() const override { return this->value_.cidrs().size(); }
+    const void* get(const std::type_info& type) const override {
+      return (type == typeid(argparse::CidrTable) ? &this->value_ :
+              Var::get(type));
+    }
+  };
+  
+  class VarIntRanges : public Var {
+  private:
+    argparse::IntRanges value_;
+    std::string str_;
+    
+  public:
+    // type is INT_RANGES or PORTS.
+    VarIntRanges(const argparse::StrView& val,
+                 argparse::ArgType type = argparse::ArgType::INT_RANGES);
+    ~VarIntRanges() = default;
+    const std::string& to_s() const override { return this->str_; }
+    const void* get(const std::type_info& type) const override {
+      return (type == typeid(argparse::IntRanges) ? &this->value_ :
+              Var::get(type));
+    }
+  };
+  
+  class VarDouble : public Var {
+  private:
+    double value_;
+    std::string str_;
+    
+  public:
+    VarDouble(const argparse::StrView& val);
+    ~VarDouble() = default;
+    const std::string& to_s() const override { return this->str_; }
+    double to_d() const override { return this->value_; }
+    const void* get(const std::type_info& type) const override {
+      return (type == typeid(double) ? &this->value_ : Var::get(type));
+    }
+  };
+  
+  class VarFloat : public Var {
+  private:
+    float value_;
+    std::string str_;
+    
+  public:
+    VarFloat(const argparse::StrView& val);
+    ~VarFloat() = default;
+    const std::string& to_s() const override { return this->str_; }
+    double to_d() const override { return this->value_; }
+    const void* get(const std::type_info& type) const override {
+      return (type == typeid(float) ? &this->value_ : Var::get(type));
+    }
+  };
+  
   class VarBool : public Var {
   private:
     bool value_;
@@ -342,12 +1388,133 @@ namespace argparse_internal {
     static const std::string false_;
     
   public:
-    VarBool(const std::string& value);
+    VarBool(const argparse::StrView& value);
     ~VarBool() = default;
     const std::string& to_s() const override {
       return (this->value_ ? VarBool::true_ : VarBool::false_);
     }
     bool is_true() const override { return this->value_; }
+    const void* get(const std::type_info& type) const override {
+      return (type == typeid(bool) ? &this->value_ : Var::get(type));
+    }
+  };
+  
+  // Function table of a user type, one static instance for each type.
+  // Values of the type are kept in a std::vector<T> made by create.
+  struct TypeTable {
+    const std::type_info *type;        // T
+    const std::type_info *array_type;  // std::vector<T>
+    void* (*create)();
+    void (*destroy)(void *values);
+    void (*truncate)(void *values, size_t n);
+    const void* (*at)(const void *values, size_t idx);
+    
+    template <typename T>
+    static void* create_values() {
+      return new std::vector<T>();
+    }
+    template <typename T>
+    static void destroy_values(void *values) {
+      delete static_cast<std::vector<T>*>(values);
+    }
+    // pop_back needs no default constructor or assignment of T.
+    template <typename T>
+    static void truncate_values(void *values, size_t n) {
+      auto *v = static_cast<std::vector<T>*>(values);
+      while (v->size() > n) {
+        v->pop_back();
+      }
+    }
+    template <typename T>
+    static const void* value_at(const void *values, size_t idx) {
+      return &(*static_cast<const std::vector<T>*>(values))[idx];
+    }
+    template <typename T>
+    static const TypeTable* of() {
+      static const TypeTable table = {
+        &typeid(T), &typeid(std::vector<T>), &TypeTable::create_values<T>,
+        &TypeTable::destroy_values<T>, &TypeTable::truncate_values<T>,
+        &TypeTable::value_at<T>,
+      };
+      return &table;
+    }
+  };
+  
+  // Converter given by argparse::Argument::type<T>(). convert appends the
+  // value to values made by table->create(), and check only converts.
+  struct Converter {
+    const TypeTable *table;
+    std::function<void(const argparse::StrView&, void*)> convert;
+    std::function<void(const argparse::StrView&)> check;
+  };
+  
+  // Call conv with StrView if it takes one, or with a std::string copy.
+  template <typename T, typename F>
+  auto call_converter(const F& conv, const argparse::StrView& val, int)
+    -> decltype(T(conv(val))) {
+    return conv(val);
+  }
+  template <typename T, typename F>
+  T call_converter(const F& conv, const argparse::StrView& val, long) {
+    return conv(val.str());
+  }
+  
+  // All values of a dest given by a Converter, in one std::vector of the
+  // type instead of a Var for each value.
+  class VarAnyArray : public Var {
+  private:
+    const TypeTable *table_;
+    void *values_;
+    std::vector<std::string> strs_;
+    std::vector<size_t> indexes_;  // position in choices
+    
+  public:
+    VarAnyArray(const TypeTable *table)
+      : table_(table), values_(table->create()) {}
+    ~VarAnyArray() { this->table_->destroy(this->values_); }
+    VarAnyArray(const VarAnyArray& obj) = delete;
+    VarAnyArray& operator=(const VarAnyArray& obj) = delete;
+    // Convert and append val, exception of the converter is thrown.
+    void push(const Converter& conv, const argparse::StrView& val,
+              size_t index) {
+      conv.convert(val, this->values_);
+      this->strs_.push_back(val.str());
+      this->indexes_.push_back(index);
+    }
+    // Drop values after n for rollback.
+    void resize(size_t n) {
+      this->table_->truncate(this->values_, n);
+      this->strs_.resize(n);
+      this->indexes_.resize(n);
+    }
+    size_t count() const override { return this->strs_.size(); }
+    const std::string& to_s() const override { return this->str_at(0); }
+    size_t to_index() const override { return this->index_at(0); }
+    const void* get(const std::type_info& type) const override {
+      return this->get_at(type, 0);
+    }
+    const std::string& str_at(size_t pos) const override {
+      if (pos >= this->strs_.size()) {
+        throw argparse::exception::IndexError("no value");
+      }
+      return this->strs_[pos];
+    }
+    size_t index_at(size_t pos) const override {
+      if (pos >= this->indexes_.size() ||
+          this->indexes_[pos] == argparse::Argument::NO_CHOICE) {
+        return Var::to_index();
+      }
+      return this->indexes_[pos];
+    }
+    // std::vector<T> of all values is given for pos 0.
+    const void* get_at(const std::type_info& type, size_t pos) const override {
+      if (type == *(this->table_->array_type) && pos == 0) {
+        return this->values_;
+      } else if (type != *(this->table_->type) || pos >= this->strs_.size()) {
+        return Var::get(type);
+      }
+      return this->table_->at(this->values_, pos);
+    }
   };
   
   class VarNull : public Var {
@@ -357,36 +1524,342 @@ namespace argparse_internal {
     bool is_null() const override { return true; }
   };
 
+  // ------------------------------------------------------------------
+  // class NameTrie: compressed prefix tree of option names such as "-a" and
+  // "--all". Lookup cost depends on length of the name, not number of names.
+  //
+  class NameTrie {
+  private:
+    struct Node {
+      std::string label;
+      bool terminal;
+      size_t count;  // number of names in the subtree
+      std::vector<Node> children;  // sorted by label[0]
+      Node(const std::string& v_label)
+        : label(v_label), terminal(false), count(0) {}
+    };
+    Node root_;
+    static size_t find_child(const Node& node, char c);
+    static void collect(const Node& node, std::string *buf,
+                        std::vector<std::string> *out);
+    const Node* find(const std::string& prefix, std::string *path) const;
+
+  public:
+    NameTrie() : root_("") {}
+    ~NameTrie() = default;
+    void clear();
+    void insert(const std::string& name);
+    // Append all names starting with prefix to out in sorted order.
+    void complete(const std::string& prefix,
+                  std::vector<std::string> *out) const;
+    // Return number of names starting with prefix, but an exact match is
+    // always 1. name is set if return value is 1.
+    size_t resolve(const std::string& prefix, std::string *name) const;
+  };
+
+  // ------------------------------------------------------------------
+  // class BKTree: metric tree of option names by edit distance for
+  // "did you mean" suggestions.
+  //
+  class BKTree {
+  private:
+    struct Node {
+      std::string name;
+      std::vector<std::pair<size_t, size_t> > children;  // (distance, index)
+      size_t max_edge;  // largest distance in children
+      Node(const std::string& v_name) : name(v_name), max_edge(0) {}
+    };
+    std::vector<Node> nodes_;
+    
+  public:
+    static const size_t NO_LIMIT = static_cast<size_t>(-1);
+    
+    BKTree() = default;
+    ~BKTree() = default;
+    void clear() { this->nodes_.clear(); }
+    void insert(const std::string& name);
+    // Append names within max_dist from query to out, closest first. No name
+    // in range is missed. Once max_results names are found, the range
+    // shrinks to the farthest of them and fewer subtrees are visited.
+    void search(const std::string& query, size_t max_dist, size_t max_results,
+                std::vector<std::string> *out) const;
+    // Edit distance of a and b, or limit + 1 if it's over limit, which
+    // stops computing as soon as it's known.
+    static size_t distance(const std::string& a, const std::string& b,
+                           std::vector<size_t> *buf, size_t limit = NO_LIMIT);
+  };
+
+  // ------------------------------------------------------------------
+  // class LimitCounter: checks argparse::Limits while arguments are read one
+  // by one. It keeps only counters and allocates nothing unless error.
+  //
+  class LimitCounter {
+  private:
+    argparse::Limits limits_;
+    size_t argc_;
+    size_t bytes_;
+    bool terminated_;  // after "--", clusters are not checked
+    
+  public:
+    LimitCounter(const argparse::Limits& limits)
+      : limits_(limits), argc_(0), bytes_(0), terminated_(false) {}
+    ~LimitCounter() = default;
+    // Return false and set err if arg is over limits.
+    bool add(const argparse::StrView& arg, std::string *err);
+    // Same as add() for a string of argv, and len is set to its length. It
+    // is measured only up to the rest of max_bytes.
+    bool add(const char *arg, size_t *len, std::string *err);
+    // Count n arguments without checking them, e.g. argc of main().
+    bool skip(size_t n, std::string *err);
+  };
+
   // ------------------------------------------------------------------
   // class ArgumentProcessor
   //
+  enum class TokenType {
+    terminator,     // "--"
+    long_option,    // "--name" or "--name=value"
+    short_options,  // "-a" or "-abc"
+    sequence,
+  };
+  
   class ArgumentProcessor {
   private:
     std::map<const std::string, std::shared_ptr<argparse::Argument> > argmap_;
     std::vector<std::unique_ptr<argparse::Argument> > argvec_;
-    size_t parse_option(const argparse::Argv& args, size_t idx,
-                        const std::string& optkey,
-                        argparse::VarMap *varmap) const;
+    // Lookup indexes built by freeze() at first use after configuration.
+    // Const parsing may run in threads, so builds hold freeze_mutex_.
+    // The BKTree is built only when a suggestion is needed.
+    bool allow_abbrev_;
+    argparse::Limits limits_;
+    size_t generation_;  // counted up by invalidate()
+    mutable std::mutex freeze_mutex_;
+    mutable std::atomic<bool> frozen_;
+    mutable std::atomic<bool> bktree_built_;
+    mutable NameTrie name_trie_;
+    mutable BKTree name_bktree_;
+    mutable std::map<const std::string, size_t> dest_ids_;
+    // seq_min_[i] is minimum number of values for argvec_[i] and following.
+    mutable std::vector<size_t> seq_min_;
     static void handle_usage_line(const argparse::Argument& arg,
                                   const std::string& tab,
                                   std::stringstream *buf, std::ostream *out);
     static void handle_help_line(const argparse::Argument& arg,
                                  std::ostream *out);
+    // Option having choices for completion, nullptr if not found.
+    const argparse::Argument* choice_option(const std::string& optkey,
+                                            bool is_long) const;
 
   public:
-    ArgumentProcessor() = default;
+    ArgumentProcessor()
+    : allow_abbrev_(false), generation_(0), frozen_(false),
+      bktree_built_(false) {}
     ~ArgumentProcessor() = default;
     
     argparse::Argument& add_argument(const std::string &name);
     void insert_option(const std::string& name, argparse::Argument* arg);
     void copy_option(const std::string& src, const std::string& dst);
     void insert_sequence(argparse::Argument *arg);
+    void set_allow_abbrev(bool allow) {
+      this->allow_abbrev_ = allow;
+      this->invalidate();
+    }
+    bool allow_abbrev() const { return this->allow_abbrev_; }
+    void set_limits(const argparse::Limits& limits) {
+      this->limits_ = limits;
+      this->invalidate();
+    }
+    const argparse::Limits& limits() const { return this->limits_; }
+    // Return index of the first argument over limits and set err, or
+    // args.size() if all are in limits. check_limits throws ParseError.
+    static size_t find_over_limit(const argparse::Limits& limits,
+                                  const argparse::ArgvView& args,
+                                  std::string *err);
+    size_t find_over_limit(const argparse::ArgvView& args,
+                           std::string *err) const {
+      return find_over_limit(this->limits_, args, err);
+    }
+    static void check_limits(const argparse::Limits& limits,
+                             const argparse::ArgvView& args);
+    void check_limits(const argparse::ArgvView& args) const {
+      check_limits(this->limits_, args);
+    }
+    void freeze() const;
+    // Called by Argument when a setting used by freeze() is changed.
+    void invalidate() {
+      this->frozen_ = false;
+      this->bktree_built_ = false;
+      this->generation_++;
+    }
+    // Changed when the configuration is changed, e.g. for indexes of
+    // argparse::ParserGroup built over several processors.
+    size_t generation() const { return this->generation_; }
+    // Names of long options for suggestions, built at first use.
+    const BKTree& suggestion_tree() const;
+    const std::map<const std::string, std::shared_ptr<argparse::Argument> >&
+      options() const { return this->argmap_; }
+    bool has_sequence() const { return ! this->argvec_.empty(); }
+    const std::vector<std::unique_ptr<argparse::Argument> >& sequences() const {
+      return this->argvec_;
+    }
+    // Available after freeze().
+    size_t dest_count() const { return this->dest_ids_.size(); }
+    size_t dest_id(const std::string& dest) const;
+    size_t seq_min(size_t idx) const { return this->seq_min_[idx]; }
+    
+    // Steps of parse_args, also used by argparse::ParserGroup.
+    // key is option name without hyphens and val is "value" of "--key=value"
+    static TokenType split_token(const argparse::StrView& arg,
+                                 std::string *key, argparse::StrView *val,
+                                 bool *has_val);
+    // lookup_option returns nullptr and find_option throws ParseError if
+    // optkey is not found. Abbreviation is expanded only if is_long.
+    const argparse::Argument* lookup_option(const std::string& optkey,
+                                            bool is_long) const;
+    // Same as lookup_option, but ambiguous is set instead of ParseError.
+    const argparse::Argument* resolve_option(const std::string& optkey,
+                                             bool is_long,
+                                             bool *ambiguous) const;
+    const argparse::Argument& find_option(const std::string& optkey,
+                                          bool is_long) const;
+    // ParseError of find_option for optkey matching several names of trie,
+    // and for optkey not found with close names in tree as suggestions.
+    static void throw_ambiguous(const NameTrie& trie,
+                                const std::string& optkey);
+    static void throw_not_found(const BKTree& tree, const std::string& optkey);
+    std::shared_ptr<argparse::VarMap> prepare() const;
+    static size_t parse_option(const argparse::ArgvView& args, size_t idx,
+                               const argparse::Argument& argument,
+                               const std::string& optkey,
+                               argparse::VarMap *varmap,
+                               const argparse::StrView *inline_val);
+    // Return values of dest of argument, ParseError if it's duplicated.
+    static std::vector<Var*>* dest_vars(const argparse::Argument& argument,
+                                        const std::string& optkey,
+                                        argparse::VarMap *varmap);
+    // seq is indexes of sequence arguments in args, and indexes of extra
+    // arguments are stored to extra (ParseError if extra is nullptr).
+    void parse_sequences(const argparse::ArgvView& args,
+                         const std::vector<size_t>& seq,
+                         argparse::VarMap *varmap,
+                         std::vector<size_t> *extra) const;
+    argparse::Values finish(std::shared_ptr<argparse::VarMap> ptr,
+                            const argparse::ArgvSpan *rest) const;
 
-    argparse::Values parse_args(const argparse::Argv& args) const;
+    // rest is arguments after "--" if they are not in args. Unknown
+    // arguments are stored to unknown if it is not nullptr.
+    argparse::Values parse_args(const argparse::ArgvView& args,
+                                const argparse::ArgvSpan *rest = nullptr,
+                                argparse::ArgvView *unknown = nullptr) const;
+    // words and cword are same as COMP_WORDS and COMP_CWORD of bash.
+    void complete(const argparse::ArgvView& words, size_t cword,
+                  std::ostream *out) const;
+    // Same as complete() over names of trie, and choice returns an option
+    // having choices or nullptr, e.g. for argparse::ParserGroup.
+    typedef std::function<const argparse::Argument*(const std::string&, bool)>
+      ChoiceLookup;
+    static void complete(const NameTrie& trie, const ChoiceLookup& choice,
+                         const argparse::ArgvView& words, size_t cword,
+                         std::ostream *out);
     void usage(const std::string& prog_name, std::ostream *out) const;
     void help(std::ostream *out) const;
+    // Usage and help of arguments of all procs as one parser.
+    static void usage(const std::string& prog_name,
+                      const std::vector<const ArgumentProcessor*>& procs,
+                      std::ostream *out);
+    static void help(const std::vector<const ArgumentProcessor*>& procs,
+                     std::ostream *out);
   };
   
+  // ------------------------------------------------------------------
+  // class EventCursor: walks arguments and reports values one by one as
+  // argparse::Event without VarMap. Number of sequence arguments is counted
+  // by a light scan first to match them in order, e.g. "SRC [SRC ...] DST".
+  //
+  class EventCursor {
+  public:
+    typedef argparse::ErrorCode Error;
+    
+  private:
+    const ArgumentProcessor& proc_;
+    const argparse::ArgvView& args_;
+    size_t idx_;                      // next argument to read
+    std::string key_;                 // option name(s) of current argument
+    std::string letter_;              // a letter of "-abc"
+    size_t key_pos_;                  // next letter of key_ for "-abc"
+    size_t opt_idx_;                  // index of current option argument
+    const argparse::Argument *opt_;   // option waiting values
+    size_t opt_count_;
+    size_t seq_total_;
+    size_t seq_pos_;                  // number of sequence arguments read
+    size_t seq_arg_;                  // index of current sequence Argument
+    size_t seq_left_;                 // rest values for seq_arg_
+    std::vector<bool> seen_;          // by dest id
+    std::vector<size_t> values_;      // by dest id, only for max_values
+    // Keys of key_value() by dest id as views of args in sorted order, a
+    // duplicated key is one value.
+    std::vector<std::pair<size_t, argparse::StrView>> keys_;
+    bool convert_;                    // call converter functions
+    bool done_;
+    Error err_;
+    size_t err_idx_;
+    const argparse::Argument *err_arg_;
+    std::string err_key_;
+    bool err_long_;                   // err_key_ is a long option
+    
+    size_t count_sequences() const;
+    bool open(const std::string& key, bool is_long,
+              const argparse::StrView *inline_val, argparse::Event *ev);
+    bool sequence(argparse::Event *ev);
+    bool emit(const argparse::Argument& arg, const argparse::StrView& value,
+              size_t idx, argparse::Event *ev);
+    // Values added to dest of arg for Limits::max_values.
+    size_t count_values(const argparse::Argument& arg,
+                        const argparse::StrView& value);
+    bool fail(Error err, size_t idx, const argparse::Argument *arg);
+    bool finish();
+    
+  public:
+    // args must outlive EventCursor. args[0] is program name. Values are
+    // not given to converter functions unless convert.
+    EventCursor(const ArgumentProcessor& proc, const argparse::ArgvView& args,
+                bool convert = true);
+    ~EventCursor() = default;
+    EventCursor(const EventCursor& obj) = delete;
+    
+    // Set next event and return true, or return false at the end or when
+    // error() is found.
+    bool next(argparse::Event *ev);
+    size_t position() const { return this->idx_; }
+    Error error() const { return this->err_; }
+    size_t error_index() const { return this->err_idx_; }
+    const argparse::Argument* error_argument() const {
+      return this->err_arg_;
+    }
+    // Throw same ParseError as parse_args for error().
+    void throw_error() const;
+  };
+  
+}
+
+namespace argparse {
+  template <typename T, typename F>
+  Argument& Argument::type(const F& conv) {
+    static_assert(! std::is_same<T, bool>::value,
+                  "std::vector<bool> can't keep values of type<bool>()");
+    auto c = std::make_shared<argparse_internal::Converter>();
+    c->table = argparse_internal::TypeTable::of<T>();
+    c->convert = [conv](const StrView& val, void *values) {
+      static_cast<std::vector<T>*>(values)->push_back(
+        argparse_internal::call_converter<T>(conv, val, 0));
+    };
+    c->check = [conv](const StrView& val) {
+      argparse_internal::call_converter<T>(conv, val, 0);
+    };
+    this->converter_ = c;
+    this->type_ = ArgType::STR;
+    return *this;
+  }
 }
 
 #endif   // __ARGPARSE_HPP__
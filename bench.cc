@@ -0,0 +1,370 @@
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <functional>
+#include <cstdlib>
+
+#include "./argparse.hpp"
+
+// Run fn for n times and output average time per call.
+static void bench(const std::string& name, size_t n,
+                  const std::function<void()>& fn) {
+  auto begin = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < n; i++) {
+    fn();
+  }
+  auto end = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double, std::nano>(end - begin).count();
+  std::cout << std::setw(40) << std::left << name << std::setw(12)
+            << std::right << std::fixed << std::setprecision(1)
+            << (ns / n) << " ns/op" << std::endl;
+}
+
+static void bench_complete() {
+  std::stringstream out;
+  argparse::Parser psr("bench");
+  psr.set_output(&out);
+  for (size_t i = 0; i < 2000; i++) {
+    std::stringstream ss;
+    ss << "--option-" << i;
+    psr.add_argument(ss.str());
+  }
+  
+  argparse::Argv unique = {"bench", "__complete", "1", "bench", "--option-19"};
+  argparse::Argv none = {"bench", "__complete", "1", "bench", "--x"};
+  bench("complete (2000 options, 11 hits)", 10000, [&]() {
+    out.str("");
+    psr.parse_args(unique);
+  });
+  bench("complete (2000 options, no hit)", 10000, [&]() {
+    out.str("");
+    psr.parse_args(none);
+  });
+}
+
+static void bench_suggest(size_t n) {
+  argparse_internal::BKTree tree;
+  for (size_t i = 0; i < n; i++) {
+    std::stringstream ss;
+    ss << "--option-" << i;
+    tree.insert(ss.str());
+  }
+  
+  std::vector<std::string> out;
+  std::stringstream name;
+  name << "suggest (" << n << " options)";
+  bench(name.str(), 1000, [&]() {
+    out.clear();
+    tree.search("--optoin-7", 2, 3, &out);
+  });
+}
+
+static void bench_sequence(size_t n) {
+  argparse::Parser psr("bench");
+  psr.add_argument("src").nargs("+");
+  psr.add_argument("dst");
+  psr.add_argument("-v").action("count");
+  
+  argparse::Argv args = {"bench"};
+  for (size_t i = 0; i < n; i++) {
+    std::stringstream ss;
+    ss << "file" << i;
+    args.push_back(ss.str());
+    if (i % 100 == 0) {
+      args.push_back("-v");
+      args.push_back("-v");
+    }
+  }
+  
+  std::stringstream name;
+  name << "SRC... DST (" << n << " args)";
+  bench(name.str(), 3, [&]() {
+    psr.parse_args(args);
+  });
+}
+
+static void bench_validate() {
+  argparse::Parser psr("bench");
+  psr.add_argument("-c", "--config").set_default("conf.yml");
+  psr.add_argument("-v", "--verbose").action("count").set_default("0");
+  psr.add_argument("-i").action("append").dest("input");
+  psr.add_argument("-n", "--num").type("int");
+  psr.add_argument("-w").action("store_const").set_const("write");
+  psr.add_argument("src").nargs("+");
+  psr.add_argument("dst");
+  
+  argparse::Argv args = {"bench", "-vv", "--config", "my.yml", "-i", "a.txt",
+                         "-i", "b.txt", "--num=10", "-w", "s1", "s2", "d"};
+  const argparse::ArgvView views(args.begin(), args.end());
+  bench("parse_args (12 args)", 100000, [&]() {
+    psr.parse_args(args);
+  });
+  bench("validate (12 args)", 100000, [&]() {
+    psr.validate(views);
+  });
+}
+
+// Same as VarInt before int64 types, with strtol and stringstream for error.
+class LegacyVarInt {
+  int value_;
+  std::string str_;
+  std::stringstream err_;
+public:
+  LegacyVarInt(const std::string& val) : value_(0), str_(val) {
+    char *e;
+    this->value_ = strtol(val.c_str(), &e, 0);
+    if (*e != '\0') {
+      this->err_ << "Invalid number format: " << val;
+    }
+  }
+  int to_i() const { return this->value_; }
+};
+
+static void bench_int() {
+  argparse::Argv args = {"0", "42", "-17", "0x7fffffff", "123456", "0b1010",
+                         "0777", "+99"};
+  const argparse::ArgvView views(args.begin(), args.end());
+  volatile int64_t sum = 0;
+  bench("legacy VarInt (8 values)", 100000, [&]() {
+    for (const auto& v : views) {
+      LegacyVarInt var(v.str());
+      sum += var.to_i();
+    }
+  });
+  bench("VarInt64 (8 values)", 100000, [&]() {
+    for (const auto& v : views) {
+      argparse_internal::VarInt64 var(v);
+      sum += var.to_i64();
+    }
+  });
+  bench("Var::parse_int (8 values)", 100000, [&]() {
+    int64_t n;
+    for (const auto& v : views) {
+      argparse_internal::Var::parse_int(v, INT64_MIN, INT64_MAX, &n);
+      sum += n;
+    }
+  });
+}
+
+static void bench_double() {
+  argparse::Argv args = {"0.5", "3.14159", "-2.5e-3", "100", "1e10",
+                         "0.001", "6.02214076e23", "12.75"};
+  const argparse::ArgvView views(args.begin(), args.end());
+  volatile double sum = 0;
+  bench("std::stod of copied string (8 values)", 100000, [&]() {
+    for (const auto& v : views) {
+      sum += std::stod(v.str());
+    }
+  });
+  bench("Var::parse_double (8 values)", 100000, [&]() {
+    double d;
+    for (const auto& v : views) {
+      argparse_internal::Var::parse_double(v, false, &d);
+      sum += d;
+    }
+  });
+}
+
+static void bench_int_list(size_t n) {
+  argparse::Parser psr("bench");
+  psr.add_argument("--ids").type("int").nargs("+");
+  psr.add_argument("--packed").type("int").nargs("+").packed(true);
+  
+  std::vector<std::string> ids(n);
+  for (size_t i = 0; i < n; i++) {
+    ids[i] = std::to_string(i * 7919 % 1000000);
+  }
+  argparse::Argv var_args = {"bench", "--ids"};
+  argparse::Argv packed_args = {"bench", "--packed"};
+  var_args.insert(var_args.end(), ids.begin(), ids.end());
+  packed_args.insert(packed_args.end(), ids.begin(), ids.end());
+  
+  const size_t loop = (n > 100000 ? 5 : 200);
+  volatile int64_t sum = 0;
+  std::stringstream name;
+  name << "int list, Var per value (" << n << ")";
+  bench(name.str(), loop, [&]() {
+    argparse::Values val = psr.parse_args(var_args);
+    for (size_t i = 0; i < val.size("ids"); i++) {
+      sum += val.to_int("ids", i);
+    }
+  });
+  name.str("");
+  name << "int list, packed (" << n << ")";
+  bench(name.str(), loop, [&]() {
+    argparse::Values val = psr.parse_args(packed_args);
+    for (auto v : val.to_int64s("packed")) {
+      sum += v;
+    }
+  });
+}
+
+static void bench_split() {
+  argparse::Parser psr("bench");
+  psr.add_argument("--features");
+  psr.add_argument("--split").split(',');
+  
+  std::string list;
+  for (size_t i = 0; i < 500; i++) {
+    list += (i > 0 ? ",feature-" : "feature-") + std::to_string(i);
+  }
+  argparse::Argv str_args = {"bench", "--features", list};
+  argparse::Argv split_args = {"bench", "--split", list};
+  
+  volatile size_t sum = 0;
+  bench("split by hand of get() (500 items)", 2000, [&]() {
+    argparse::Values val = psr.parse_args(str_args);
+    std::vector<std::string> items;
+    std::stringstream ss(val["features"]);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+      items.push_back(item);
+    }
+    sum += items.size();
+  });
+  bench("split() list (500 items)", 2000, [&]() {
+    argparse::Values val = psr.parse_args(split_args);
+    for (auto v : val.to_list("split")) {
+      sum += v.size();
+    }
+  });
+}
+
+static void bench_key_value() {
+  argparse::Parser psr("bench");
+  psr.add_argument("-a").action("append");
+  psr.add_argument("-D").action("append").key_value();
+  
+  argparse::Argv append_args = {"bench"}, map_args = {"bench"};
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < 200; i++) {
+    keys.push_back("section.key" + std::to_string(i));
+    append_args.push_back("-a");
+    append_args.push_back(keys.back() + "=" + std::to_string(i));
+    map_args.push_back("-D");
+    map_args.push_back(keys.back() + "=" + std::to_string(i));
+  }
+  argparse::Values append_val = psr.parse_args(append_args);
+  argparse::Values map_val = psr.parse_args(map_args);
+  
+  volatile size_t sum = 0;
+  bench("lookup by scan of append (200 keys)", 1000, [&]() {
+    for (const auto& key : keys) {
+      for (size_t i = 0; i < append_val.size("a"); i++) {
+        const std::string& item = append_val.get("a", i);
+        const size_t eq = item.find('=');
+        if (item.compare(0, eq, key) == 0) {
+          sum += item.length() - eq;
+          break;
+        }
+      }
+    }
+  });
+  bench("lookup by get_map (200 keys)", 1000, [&]() {
+    const argparse::KeyValueMap& map = map_val.get_map("D");
+    for (const auto& key : keys) {
+      sum += map.find(key)->value.size();
+    }
+  });
+}
+
+static void bench_cidr() {
+  argparse::Parser psr("bench");
+  psr.add_argument("--allow").type("cidr");
+  
+  // 2000 blocks of /24 in 10.0.0.0/8 with gaps.
+  std::string list;
+  for (size_t i = 0; i < 2000; i++) {
+    const size_t n = i * 3;
+    list += (i > 0 ? ",10." : "10.") + std::to_string(n / 256) + "." +
+      std::to_string(n % 256) + ".0/24";
+  }
+  argparse::Argv args = {"bench", "--allow", list};
+  bench("parse cidr list (2000 blocks)", 200, [&]() {
+    psr.parse_args(args);
+  });
+  
+  argparse::Values val = psr.parse_args(args);
+  const argparse::CidrTable& table = val.to_cidrs("allow");
+  std::vector<argparse::IPAddress> addrs(256);
+  for (size_t i = 0; i < addrs.size(); i++) {
+    argparse::IPAddress::parse_v4("10." + std::to_string(i / 16) + "." +
+                                  std::to_string(i * 7 % 256) + ".1",
+                                  &addrs[i]);
+  }
+  
+  volatile size_t sum = 0;
+  bench("contains by scan of blocks (256 addrs)", 100, [&]() {
+    for (const auto& a : addrs) {
+      for (const auto& c : table.cidrs()) {
+        const uint32_t mask = ~0u << (32 - c.length);
+        if ((a.v4() & mask) == c.addr.v4()) {
+          sum += 1;
+          break;
+        }
+      }
+    }
+  });
+  bench("CidrTable::contains (256 addrs)", 100, [&]() {
+    for (const auto& a : addrs) {
+      sum += table.contains(a);
+    }
+  });
+}
+
+static void bench_bytes() {
+  std::string hex;
+  for (size_t i = 0; i < 256; i++) {
+    static const char digits[] = "0123456789abcdef";
+    hex += digits[i * 7 % 16];
+    hex += digits[i * 13 % 16];
+  }
+  const argparse::StrView view(hex.data(), hex.size());
+  
+  volatile size_t sum = 0;
+  bench("hex by strtol of copied pairs (256 bytes)", 10000, [&]() {
+    std::string s = view.str();
+    std::vector<uint8_t> out;
+    for (size_t i = 0; i < s.size(); i += 2) {
+      out.push_back(strtol(s.substr(i, 2).c_str(), nullptr, 16));
+    }
+    sum += out.size();
+  });
+  bench("Var::decode_hex (256 bytes)", 10000, [&]() {
+    std::vector<uint8_t> out;
+    argparse_internal::Var::decode_hex(view, &out);
+    sum += out.size();
+  });
+  
+  std::string b64;
+  static const char alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  for (size_t i = 0; i < 344; i++) {
+    b64 += alphabet[i * 11 % 64];
+  }
+  const argparse::StrView b64_view(b64.data(), b64.size());
+  bench("Var::decode_base64 (258 bytes)", 10000, [&]() {
+    std::vector<uint8_t> out;
+    argparse_internal::Var::decode_base64(b64_view, &out);
+    sum += out.size();
+  });
+}
+
+int main(int argc, char *argv[]) {
+  bench_complete();
+  bench_suggest(100);
+  bench_suggest(10000);
+  bench_sequence(10000);
+  bench_sequence(1000000);
+  bench_validate();
+  bench_int();
+  bench_double();
+  bench_int_list(10000);
+  bench_int_list(1000000);
+  bench_split();
+  bench_key_value();
+  bench_cidr();
+  bench_bytes();
+  return 0;
+}
@@ -28,8 +28,8 @@ int main(int argc, char *argv[]) {
   // Parse
   argparse::Values val = psr.parse_args(argc, argv);
   
-  // Exit if help was shown.
-  if (val.is_help_mode()) {
+  // Exit if help or shell completion was shown.
+  if (val.is_help_mode() || val.is_complete_mode()) {
     return 0;
   }
   
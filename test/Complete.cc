@@ -0,0 +1,93 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+
+class Complete : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  std::stringstream out;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->set_output(&out);
+    psr->add_argument("-a", "--alpha");
+    psr->add_argument("--all").action("store_true");
+    psr->add_argument("-b", "--beta").required(true);
+    psr->add_argument("x");
+  }
+  
+  virtual void TearDown() { delete psr; }
+};
+
+TEST_F(Complete, long_prefix) {
+  argparse::Argv seq = {"./test", "__complete", "1", "./test", "--al"};
+  argparse::Values val = psr->parse_args(seq);
+  EXPECT_TRUE(val.is_complete_mode());
+  EXPECT_FALSE(val.is_help_mode());
+  EXPECT_EQ("--all\n--alpha\n", out.str());
+}
+
+TEST_F(Complete, all_options) {
+  argparse::Argv seq = {"./test", "__complete", "2", "./test", "x", "-"};
+  psr->parse_args(seq);
+  EXPECT_EQ("--all\n--alpha\n--beta\n--help\n-a\n-b\n-h\n", out.str());
+}
+
+TEST_F(Complete, no_candidate) {
+  // Required option and sequence argument are not checked in completion.
+  argparse::Argv seq1 = {"./test", "__complete", "1", "./test", "--z"};
+  argparse::Argv seq2 = {"./test", "__complete", "1", "./test", "abc"};
+  argparse::Argv seq3 = {"./test", "__complete", "5", "./test"};
+  EXPECT_TRUE(psr->parse_args(seq1).is_complete_mode());
+  EXPECT_TRUE(psr->parse_args(seq2).is_complete_mode());
+  EXPECT_TRUE(psr->parse_args(seq3).is_complete_mode());
+  EXPECT_EQ("", out.str());
+}
+
+TEST_F(Complete, script) {
+  psr->completion_script("bash");
+  EXPECT_NE(std::string::npos,
+            out.str().find("test __complete \"$COMP_CWORD\""));
+  EXPECT_NE(std::string::npos, out.str().find("complete -o default -F"));
+
+  out.str("");
+  psr->completion_script("zsh");
+  EXPECT_NE(std::string::npos, out.str().find("#compdef test"));
+  
+  out.str("");
+  psr->completion_script("fish");
+  EXPECT_NE(std::string::npos, out.str().find("complete -c test"));
+  
+  EXPECT_THROW(psr->completion_script("csh"),
+               argparse::exception::ConfigureError);
+}
@@ -28,6 +28,9 @@
 
 #include <vector>
 #include <string>
+#include <thread>
+
+#include <stdio.h>
 
 #include "./gtest.h"
 #include "../argparse.hpp"
@@ -163,3 +166,119 @@ TEST(Parser, help_by_option) {
   psr.parse_args(seq);
   EXPECT_FALSE(out.str().empty());
 }
+
+TEST(Parser, suggestion) {
+  argparse::Parser psr("test");
+  psr.add_argument("--verbose").action("store_true");
+  psr.add_argument("--version").action("store_true");
+  psr.add_argument("--output");
+  
+  argparse::Argv seq1 = {"./test", "--verbse"};
+  try {
+    psr.parse_args(seq1);
+    FAIL();
+  } catch (argparse::exception::ParseError& e) {
+    ASSERT_EQ(1, e.suggestions().size());
+    EXPECT_EQ("--verbose", e.suggestions()[0]);
+    EXPECT_EQ("ParseError: option not found: verbse, did you mean --verbose?",
+              std::string(e.what()));
+  }
+  
+  argparse::Argv seq2 = {"./test", "--verzion"};
+  try {
+    psr.parse_args(seq2);
+    FAIL();
+  } catch (argparse::exception::ParseError& e) {
+    ASSERT_EQ(1, e.suggestions().size());
+    EXPECT_EQ("--version", e.suggestions()[0]);
+  }
+
+  argparse::Argv seq3 = {"./test", "--zzzzzz"};
+  try {
+    psr.parse_args(seq3);
+    FAIL();
+  } catch (argparse::exception::ParseError& e) {
+    EXPECT_TRUE(e.suggestions().empty());
+    EXPECT_EQ("ParseError: option not found: zzzzzz", std::string(e.what()));
+  }
+}
+
+TEST(BKTree, search) {
+  argparse_internal::BKTree tree;
+  std::vector<size_t> buf;
+  EXPECT_EQ(3, argparse_internal::BKTree::distance("kitten", "sitting", &buf));
+  EXPECT_EQ(0, argparse_internal::BKTree::distance("", "", &buf));
+  
+  tree.insert("--input");
+  tree.insert("--output");
+  tree.insert("--inputs");
+  tree.insert("--outfile");
+  
+  std::vector<std::string> out;
+  tree.search("--inptu", 2, 3, &out);
+  ASSERT_EQ(2, out.size());
+  EXPECT_EQ("--input", out[0]);
+  EXPECT_EQ("--inputs", out[1]);
+}
+
+TEST(BKTree, large_schema) {
+  argparse::Parser psr("test");
+  for (int i = 0; i < 10000; i++) {
+    char name[32];
+    snprintf(name, sizeof(name), "--option-%05d", i);
+    psr.add_argument(name).action("store_true");
+  }
+  
+  // One edit from a name of the schema, the name itself must come first.
+  const char *typos[] = {"--option-%05dq", "--optio-%05d", "--option_%05d",
+                         "--option-%05d-"};
+  for (int i = 0; i < 10000; i += 101) {
+    char name[32], typo[32];
+    snprintf(name, sizeof(name), "--option-%05d", i);
+    snprintf(typo, sizeof(typo), typos[i % 4], i);
+    try {
+      psr.parse_args(argparse::Argv({"./test", typo}));
+      FAIL();
+    } catch (const argparse::exception::ParseError& e) {
+      ASSERT_FALSE(e.suggestions().empty()) << typo;
+      EXPECT_EQ(name, e.suggestions()[0]) << typo;
+    }
+  }
+}
+
+TEST(Parser, first_parse_in_threads) {
+  argparse::Parser psr("test");
+  psr.add_argument("--verbose").action("store_true");
+  psr.add_argument("-n").type("int");
+  psr.add_argument("src").nargs("+");
+  const argparse::Parser& shared = psr;
+  
+  std::vector<int> ok(8, 0);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < ok.size(); i++) {
+    threads.push_back(std::thread([&shared, &ok, i]() {
+      argparse::Values val = shared.parse_args(argparse::Argv({
+            "./test", "--verbose", "-n", "3", "a", "b", "c"}));
+      try {
+        shared.parse_args(argparse::Argv({"./test", "--verbse", "a", "b"}));
+      } catch (const argparse::exception::ParseError& e) {
+        ok[i] = (val.is_true("verbose") && val.size("src") == 3 &&
+                 e.suggestions().size() == 1);
+      }
+    }));
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(std::vector<int>(8, 1), ok);
+  
+  // Suggestions follow options added after parsing.
+  psr.add_argument("--output");
+  try {
+    psr.parse_args(argparse::Argv({"./test", "--outptu", "a", "b"}));
+    FAIL();
+  } catch (const argparse::exception::ParseError& e) {
+    ASSERT_EQ(1, e.suggestions().size());
+    EXPECT_EQ("--output", e.suggestions()[0]);
+  }
+}
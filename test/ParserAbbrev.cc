@@ -0,0 +1,125 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+
+class ParserAbbrev : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->add_argument("--verbose").action("store_true");
+    psr->add_argument("--version").action("store_true");
+    psr->add_argument("--input");
+    psr->add_argument("--in");
+    psr->allow_abbrev(true);
+  }
+  
+  virtual void TearDown() { delete psr; }
+};
+
+TEST_F(ParserAbbrev, unique_prefix) {
+  argparse::Argv seq = {"./test", "--verb", "--inp", "f1"};
+  argparse::Values val = psr->parse_args(seq);
+  EXPECT_TRUE(val.is_true("verbose"));
+  EXPECT_FALSE(val.is_true("version"));
+  EXPECT_EQ("f1", val["input"]);
+}
+
+TEST_F(ParserAbbrev, exact_match_first) {
+  // "--in" is also a prefix of "--input", but exact match is prior.
+  argparse::Argv seq = {"./test", "--in", "f1"};
+  argparse::Values val = psr->parse_args(seq);
+  EXPECT_EQ("f1", val["in"]);
+  EXPECT_FALSE(val.is_set("input"));
+}
+
+TEST_F(ParserAbbrev, ambiguous) {
+  argparse::Argv seq = {"./test", "--ver"};
+  EXPECT_THROW(psr->parse_args(seq), argparse::exception::ParseError);
+  try {
+    psr->parse_args(seq);
+  } catch (argparse::exception::ParseError& e) {
+    EXPECT_EQ("ParseError: ambiguous option: --ver could match "
+              "--verbose, --version", std::string(e.what()));
+  }
+}
+
+TEST_F(ParserAbbrev, one_letter_prefix) {
+  psr->add_argument("--output");
+  argparse::Values val = psr->parse_args(argparse::Argv({"./test", "--o",
+                                                         "f1"}));
+  EXPECT_EQ("f1", val["output"]);
+  EXPECT_TRUE(psr->validate(argparse::Argv({"./test", "--o", "f1"})).ok());
+  
+  argparse::Argv seq = {"./test", "--v"};
+  EXPECT_THROW(psr->parse_args(seq), argparse::exception::ParseError);
+  EXPECT_EQ(argparse::ErrorCode::ambiguous_option, psr->validate(seq).code);
+  
+  // A short option is not an abbreviation.
+  seq = {"./test", "-o", "f1"};
+  EXPECT_THROW(psr->parse_args(seq), argparse::exception::ParseError);
+  EXPECT_EQ(argparse::ErrorCode::unknown_option, psr->validate(seq).code);
+}
+
+TEST_F(ParserAbbrev, disabled) {
+  psr->allow_abbrev(false);
+  argparse::Argv seq = {"./test", "--verb"};
+  EXPECT_THROW(psr->parse_args(seq), argparse::exception::ParseError);
+}
+
+TEST(NameTrie, resolve) {
+  argparse_internal::NameTrie trie;
+  trie.insert("--alpha");
+  trie.insert("--all");
+  trie.insert("--beta");
+  trie.insert("-a");
+  
+  std::string name;
+  EXPECT_EQ(4, trie.resolve("-", &name));
+  EXPECT_EQ(2, trie.resolve("--al", &name));
+  EXPECT_EQ(1, trie.resolve("--alp", &name));
+  EXPECT_EQ("--alpha", name);
+  EXPECT_EQ(1, trie.resolve("--b", &name));
+  EXPECT_EQ("--beta", name);
+  EXPECT_EQ(1, trie.resolve("--all", &name));
+  EXPECT_EQ("--all", name);
+  EXPECT_EQ(0, trie.resolve("--alx", &name));
+  EXPECT_EQ(0, trie.resolve("--alphabet", &name));
+  
+  std::vector<std::string> out;
+  trie.complete("--a", &out);
+  ASSERT_EQ(2, out.size());
+  EXPECT_EQ("--all", out[0]);
+  EXPECT_EQ("--alpha", out[1]);
+}
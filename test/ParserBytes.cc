@@ -0,0 +1,148 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+
+class ParserBytes : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->add_argument("--hex").type("hex");
+    psr->add_argument("--b64").type("base64");
+    psr->add_argument("--key").type("hex").bytes(32);
+    psr->add_argument("--nonce").type("base64").bytes(12).action("append");
+  }
+  virtual void TearDown() { delete psr; }
+  
+  std::vector<uint8_t> decode(const std::string& opt, const std::string& v) {
+    argparse::Values val = psr->parse_args(argparse::Argv({
+          "./test", "--" + opt, v}));
+    argparse::ByteSpan bytes = val.to_bytes(opt);
+    return std::vector<uint8_t>(bytes.begin(), bytes.end());
+  }
+  
+  bool valid(const std::string& opt, const std::string& v) {
+    return psr->validate(argparse::Argv({"./test", "--" + opt, v})).ok();
+  }
+};
+
+TEST_F(ParserBytes, hex) {
+  EXPECT_EQ(std::vector<uint8_t>({0x00, 0xff, 0x1a}), decode("hex", "00ff1A"));
+  EXPECT_EQ(std::vector<uint8_t>({0xde, 0xad, 0xbe, 0xef}),
+            decode("hex", "0xDEADbeef"));
+  EXPECT_EQ(std::vector<uint8_t>(), decode("hex", ""));
+  
+  std::vector<uint8_t> expected;
+  std::string digits;
+  for (int i = 0; i < 19; i++) {
+    expected.push_back(static_cast<uint8_t>(i * 37));
+    char buf[3];
+    snprintf(buf, sizeof(buf), "%02x", i * 37 % 256);
+    digits += buf;
+  }
+  EXPECT_EQ(expected, decode("hex", digits));
+  
+  argparse::Values val = psr->parse_args(argparse::Argv({
+        "./test", "--hex", "0a0b"}));
+  EXPECT_EQ("0a0b", val["hex"]);
+  EXPECT_EQ(2u, val.get<std::vector<uint8_t>>("hex").size());
+  EXPECT_EQ(val.get<std::vector<uint8_t>>("hex").data(),
+            val.to_bytes("hex").data());
+}
+
+TEST_F(ParserBytes, hex_error) {
+  EXPECT_THROW(decode("hex", "abc"), argparse::exception::ParseError);
+  EXPECT_THROW(decode("hex", "0x"), argparse::exception::ParseError);
+  EXPECT_THROW(decode("hex", "0g"), argparse::exception::ParseError);
+  // An invalid digit in 8 digits block and in the tail.
+  EXPECT_THROW(decode("hex", "0011223x"), argparse::exception::ParseError);
+  EXPECT_THROW(decode("hex", "001122334z"), argparse::exception::ParseError);
+  EXPECT_THROW(decode("hex", "00 11"), argparse::exception::ParseError);
+  EXPECT_FALSE(valid("hex", "abc"));
+  EXPECT_TRUE(valid("hex", "abcd"));
+}
+
+TEST_F(ParserBytes, base64) {
+  EXPECT_EQ(std::vector<uint8_t>(), decode("b64", ""));
+  const std::string text = "foobar";
+  EXPECT_EQ(std::vector<uint8_t>(text.begin(), text.begin() + 1),
+            decode("b64", "Zg=="));
+  EXPECT_EQ(std::vector<uint8_t>(text.begin(), text.begin() + 2),
+            decode("b64", "Zm8="));
+  EXPECT_EQ(std::vector<uint8_t>(text.begin(), text.begin() + 3),
+            decode("b64", "Zm9v"));
+  EXPECT_EQ(std::vector<uint8_t>(text.begin(), text.end()),
+            decode("b64", "Zm9vYmFy"));
+  EXPECT_EQ(std::vector<uint8_t>({0xfb, 0xff, 0xbf}), decode("b64", "+/+/"));
+}
+
+TEST_F(ParserBytes, base64_error) {
+  EXPECT_THROW(decode("b64", "Zg"), argparse::exception::ParseError);
+  EXPECT_THROW(decode("b64", "Zg="), argparse::exception::ParseError);
+  EXPECT_THROW(decode("b64", "Z==="), argparse::exception::ParseError);
+  EXPECT_THROW(decode("b64", "===="), argparse::exception::ParseError);
+  EXPECT_THROW(decode("b64", "Zg==Zg=="), argparse::exception::ParseError);
+  EXPECT_THROW(decode("b64", "Zm9-"), argparse::exception::ParseError);
+  // Unused bits must be zero.
+  EXPECT_THROW(decode("b64", "Zh=="), argparse::exception::ParseError);
+  EXPECT_THROW(decode("b64", "Zm9="), argparse::exception::ParseError);
+  EXPECT_FALSE(valid("b64", "Zh=="));
+  EXPECT_TRUE(valid("b64", "Zg=="));
+}
+
+TEST_F(ParserBytes, length) {
+  const std::string key(64, 'a');
+  EXPECT_EQ(32u, decode("key", key).size());
+  EXPECT_EQ(32u, decode("key", "0x" + key).size());
+  EXPECT_THROW(decode("key", key + "aa"), argparse::exception::ParseError);
+  EXPECT_THROW(decode("key", key.substr(2)), argparse::exception::ParseError);
+  EXPECT_FALSE(valid("key", key.substr(2)));
+  EXPECT_TRUE(valid("key", key));
+  
+  argparse::Values val = psr->parse_args(argparse::Argv({
+        "./test", "--nonce", "AAAAAAAAAAAAAAAA", "--nonce",
+        "////////////////"}));
+  ASSERT_EQ(2u, val.size("nonce"));
+  EXPECT_EQ(12u, val.to_bytes("nonce", 1).size());
+  EXPECT_EQ(0xff, val.to_bytes("nonce", 1)[11]);
+  EXPECT_THROW(decode("nonce", "AAAAAAAAAAAAAA=="),
+               argparse::exception::ParseError);
+}
+
+TEST_F(ParserBytes, configure_error) {
+  argparse::Parser p("test");
+  p.add_argument("--key").bytes(16);
+  EXPECT_THROW(p.parse_args(argparse::Argv({"./test"})),
+               argparse::exception::ConfigureError);
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+#include <sstream>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+
+enum class Mode { read, write, append };
+
+class ParserChoices : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  std::stringstream out;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->set_output(&out);
+    psr->add_argument("-m", "--mode").choices({"read", "write", "append"})
+      .set_default("read");
+    psr->add_argument("-l", "--level").action("append")
+      .choices({"low", "mid", "high"});
+    psr->add_argument("-v").action("count");
+    psr->add_argument("color").nargs("?").choices({"red", "green"});
+  }
+  
+  virtual void TearDown() { delete psr; }
+};
+
+TEST_F(ParserChoices, index) {
+  argparse::Values val = psr->parse_args(argparse::Argv({
+        "./test", "--mode", "append", "-l", "high", "--level=low", "green"}));
+  EXPECT_EQ("append", val["mode"]);
+  EXPECT_EQ(2, val.to_index("mode"));
+  EXPECT_EQ(Mode::append, val.as_enum<Mode>("mode"));
+  ASSERT_EQ(2, val.size("level"));
+  EXPECT_EQ(2, val.to_index("level", 0));
+  EXPECT_EQ(0, val.to_index("level", 1));
+  EXPECT_EQ(1, val.to_index("color"));
+  
+  // Default is also a choice.
+  val = psr->parse_args(argparse::Argv({"./test", "-vv"}));
+  EXPECT_EQ(Mode::read, val.as_enum<Mode>("mode"));
+  EXPECT_THROW(val.to_index("v"), argparse::exception::TypeError);
+}
+
+TEST_F(ParserChoices, invalid) {
+  EXPECT_THROW(psr->parse_args(argparse::Argv({"./test", "-m", "rea"})),
+               argparse::exception::ParseError);
+  EXPECT_THROW(psr->parse_args(argparse::Argv({"./test", "--mode=x"})),
+               argparse::exception::ParseError);
+  EXPECT_THROW(psr->parse_args(argparse::Argv({"./test", "blue"})),
+               argparse::exception::ParseError);
+  
+  try {
+    psr->parse_args(argparse::Argv({"./test", "-l", "mid", "-l", "top"}));
+    FAIL();
+  } catch (const argparse::exception::ParseError& e) {
+    EXPECT_NE(std::string::npos,
+              std::string(e.what()).find("(choose from low, mid, high)"));
+  }
+  
+  argparse::ParseStatus st = psr->validate(argparse::Argv({
+        "./test", "-l", "mid", "-l", "top"}));
+  EXPECT_EQ(argparse::ErrorCode::invalid_choice, st.code);
+  EXPECT_EQ(4, st.index);
+}
+
+TEST_F(ParserChoices, events) {
+  argparse::Argv args = {"./test", "-m", "write", "red"};
+  const argparse::ArgvView views(args.begin(), args.end());
+  std::vector<size_t> idx;
+  psr->parse_events(views, [&](const argparse::Event& ev) {
+      idx.push_back(ev.arg->find_choice(ev.value));
+      return true;
+    });
+  ASSERT_EQ(2, idx.size());
+  EXPECT_EQ(1, idx[0]);
+  EXPECT_EQ(0, idx[1]);
+}
+
+TEST_F(ParserChoices, configure_error) {
+  argparse::Parser p1("test");
+  p1.add_argument("-a").type("int").choices({"1", "2"});
+  EXPECT_THROW(p1.parse_args(argparse::Argv({"./test"})),
+               argparse::exception::ConfigureError);
+  
+  argparse::Parser p2("test");
+  p2.add_argument("-a").choices({"x", "y"}).set_default("z");
+  EXPECT_THROW(p2.parse_args(argparse::Argv({"./test"})),
+               argparse::exception::ConfigureError);
+}
+
+TEST_F(ParserChoices, complete) {
+  psr->parse_args(argparse::Argv({"./test", "__complete", "2", "./test",
+                                  "--mode", ""}));
+  EXPECT_EQ("append\nread\nwrite\n", out.str());
+  
+  out.str("");
+  psr->parse_args(argparse::Argv({"./test", "__complete", "2", "./test",
+                                  "-vl", "m"}));
+  EXPECT_EQ("mid\n", out.str());
+  
+  out.str("");
+  psr->parse_args(argparse::Argv({"./test", "__complete", "1", "./test",
+                                  "--mode=w"}));
+  EXPECT_EQ("--mode=write\n", out.str());
+  
+  out.str("");
+  psr->parse_args(argparse::Argv({"./test", "__complete", "2", "./test",
+                                  "-v", "r"}));
+  EXPECT_EQ("", out.str());
+}
+
+TEST_F(ParserChoices, usage) {
+  psr->help();
+  EXPECT_NE(std::string::npos, out.str().find("{read,write,append}"));
+}
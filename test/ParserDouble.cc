@@ -0,0 +1,207 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+#include <random>
+#include <sstream>
+#include <iomanip>
+
+#include <math.h>
+#include <float.h>
+#include <stdlib.h>
+#include <locale.h>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+
+class ParserDouble : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->add_argument("-r", "--rate").type("double");
+    psr->add_argument("-f", "--fraction").type("float");
+    psr->add_argument("-x", "--extra").type("double").nonfinite(true);
+    psr->add_argument("-p", "--point").type("double").nargs("+");
+  }
+  virtual void TearDown() { delete psr; }
+  
+  argparse::Values parse(const std::string& arg) {
+    return psr->parse_args(argparse::Argv({"./test", arg}));
+  }
+};
+
+TEST_F(ParserDouble, parse) {
+  EXPECT_EQ(0.25, parse("--rate=0.25").to_double("rate"));
+  EXPECT_EQ(0.25, parse("--rate=.25").get<double>("rate"));
+  EXPECT_EQ(-3.0, parse("--rate=-3.").to_double("rate"));
+  EXPECT_EQ(1.5e-7, parse("--rate=+1.5E-7").to_double("rate"));
+  EXPECT_EQ(1e300, parse("--rate=1e300").to_double("rate"));
+  EXPECT_EQ(DBL_MAX, parse("--rate=1.7976931348623157e308").to_double("rate"));
+  EXPECT_EQ(0.0, parse("--rate=1e-400").to_double("rate"));
+  EXPECT_EQ(42.0, parse("--rate=42").to_double("rate"));
+  EXPECT_EQ(0.1f, parse("--fraction=0.1").get<float>("fraction"));
+  EXPECT_EQ(static_cast<double>(0.1f),
+            parse("--fraction=0.1").to_double("fraction"));
+  EXPECT_EQ("0.25", parse("--rate=0.25")["rate"]);
+}
+
+TEST_F(ParserDouble, invalid) {
+  const std::vector<std::string> invalid = {
+    "", ".", "-", "e5", "1e", "1e+", "1.5x", "0x10", "1,5", " 1", "1 ",
+    "--1", "1..2", "in", "nana",
+  };
+  for (const auto& v : invalid) {
+    EXPECT_THROW(parse("--rate=" + v), argparse::exception::ParseError) << v;
+  }
+}
+
+TEST_F(ParserDouble, range) {
+  EXPECT_THROW(parse("--rate=1e309"), argparse::exception::ParseError);
+  EXPECT_THROW(parse("--rate=-2e308"), argparse::exception::ParseError);
+  EXPECT_THROW(parse("--fraction=1e39"), argparse::exception::ParseError);
+  EXPECT_EQ(1e38f, parse("--fraction=1e38").get<float>("fraction"));
+}
+
+TEST_F(ParserDouble, float_rounding) {
+  // Rounding to double first gives 1.0f, it's just above a half of ulp.
+  const std::string v = "1.000000059604644775390625000000001";
+  EXPECT_EQ(strtof(v.c_str(), nullptr),
+            parse("--fraction=" + v).get<float>("fraction"));
+  EXPECT_NE(1.0f, parse("--fraction=" + v).get<float>("fraction"));
+  EXPECT_EQ(0.1f, parse("--fraction=0.1").get<float>("fraction"));
+  EXPECT_EQ(FLT_MAX, parse("--fraction=3.4028235e38").get<float>("fraction"));
+  
+  std::mt19937_64 rng(2);
+  std::uniform_int_distribution<int> exp(-50, 40);
+  std::uniform_int_distribution<int> digits(1, 12);
+  for (size_t i = 0; i < 20000; i++) {
+    std::stringstream ss;
+    const int n = digits(rng);
+    for (int k = 0; k < n; k++) {
+      if (k == n / 2) {
+        ss << '.';
+      }
+      ss << static_cast<char>('0' + rng() % 10);
+    }
+    if (i % 2 == 0) {
+      ss << "e" << exp(rng);
+    }
+    const std::string v = ss.str();
+    const float expected = strtof(v.c_str(), nullptr);
+    double d;
+    if (expected > FLT_MAX) {
+      EXPECT_EQ(argparse_internal::Var::NumResult::out_of_range,
+                argparse_internal::Var::parse_double(v, true, &d)) << v;
+    } else {
+      EXPECT_EQ(argparse_internal::Var::NumResult::ok,
+                argparse_internal::Var::parse_double(v, true, &d)) << v;
+      EXPECT_EQ(expected, static_cast<float>(d)) << v;
+    }
+  }
+}
+
+TEST_F(ParserDouble, locale) {
+  // Decimal point of the process locale is not used.
+  const char *names[] = {"de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8",
+                         "fr_FR.utf8"};
+  std::string saved = setlocale(LC_NUMERIC, nullptr);
+  bool found = false;
+  for (const char *name : names) {
+    if (setlocale(LC_NUMERIC, name) != nullptr) {
+      found = true;
+      break;
+    }
+  }
+  if (found) {
+    EXPECT_EQ(2.5, parse("--rate=2.5").to_double("rate"));
+    // Over digits of the fast path.
+    EXPECT_EQ(0.12345678901234567890123,
+              parse("--rate=0.12345678901234567890123").to_double("rate"));
+    EXPECT_EQ(1.5e-30f, parse("--fraction=1.5e-30").get<float>("fraction"));
+    EXPECT_THROW(parse("--rate=2,5"), argparse::exception::ParseError);
+  }
+  setlocale(LC_NUMERIC, saved.c_str());
+}
+
+TEST_F(ParserDouble, nonfinite) {
+  EXPECT_THROW(parse("--rate=nan"), argparse::exception::ParseError);
+  EXPECT_THROW(parse("--rate=inf"), argparse::exception::ParseError);
+  EXPECT_THROW(parse("--fraction=-Infinity"), argparse::exception::ParseError);
+  
+  EXPECT_TRUE(isnan(parse("--extra=NaN").to_double("extra")));
+  EXPECT_EQ(HUGE_VAL, parse("--extra=inf").to_double("extra"));
+  EXPECT_EQ(-HUGE_VAL, parse("--extra=-infinity").to_double("extra"));
+  
+  argparse::ParseStatus st = psr->validate(argparse::Argv({
+        "./test", "--rate=inf"}));
+  EXPECT_EQ(argparse::ErrorCode::invalid_value, st.code);
+  st = psr->validate(argparse::Argv({"./test", "--extra=inf"}));
+  EXPECT_TRUE(st.ok());
+}
+
+TEST_F(ParserDouble, list) {
+  argparse::Values val = psr->parse_args(argparse::Argv({
+        "./test", "-p", "1", "2.5", "1e3"}));
+  const std::vector<double> expected = {1.0, 2.5, 1000.0};
+  EXPECT_EQ(expected, val.to_doubles("point"));
+  EXPECT_THROW(psr->parse_args(argparse::Argv({"./test", "-p", "1", "x"})),
+               argparse::exception::ParseError);
+}
+
+TEST_F(ParserDouble, same_as_strtod) {
+  std::mt19937_64 rng(1);
+  std::uniform_int_distribution<int> exp(-320, 310);
+  std::uniform_int_distribution<int> digits(1, 25);
+  for (size_t i = 0; i < 20000; i++) {
+    std::stringstream ss;
+    const int n = digits(rng);
+    for (int k = 0; k < n; k++) {
+      if (k == n / 2) {
+        ss << '.';
+      }
+      ss << static_cast<char>('0' + rng() % 10);
+    }
+    if (i % 3 == 0) {
+      ss << "e" << exp(rng);
+    }
+    const std::string v = ss.str();
+    const double expected = strtod(v.c_str(), nullptr);
+    double d;
+    if (expected > DBL_MAX) {
+      EXPECT_EQ(argparse_internal::Var::NumResult::out_of_range,
+                argparse_internal::Var::parse_double(v, false, &d)) << v;
+    } else {
+      EXPECT_EQ(argparse_internal::Var::NumResult::ok,
+                argparse_internal::Var::parse_double(v, false, &d)) << v;
+      EXPECT_EQ(expected, d) << v;
+    }
+  }
+}
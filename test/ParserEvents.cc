@@ -0,0 +1,234 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+
+class ParserEvents : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  std::vector<argparse::Event> events;
+  std::vector<std::string> values;
+  
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->add_argument("-f").action("append").dest("from");
+    psr->add_argument("-t").action("append").dest("to");
+    psr->add_argument("-b").nargs(2);
+    psr->add_argument("-n").type("int");
+    psr->add_argument("-v").action("count");
+    psr->add_argument("-w").action("store_const").set_const("write");
+    psr->add_argument("--version").action("store_true");
+    psr->add_argument("src").nargs("+");
+    psr->add_argument("dst");
+  }
+  
+  virtual void TearDown() { delete psr; }
+  
+  size_t parse(const argparse::Argv& args) {
+    const argparse::ArgvView views(args.begin(), args.end());
+    return psr->parse_events(views, [this](const argparse::Event& ev) {
+        this->events.push_back(ev);
+        this->values.push_back(ev.value.str());
+        return true;
+      });
+  }
+};
+
+TEST_F(ParserEvents, order) {
+  argparse::Argv args = {"./test", "-f", "a", "-t", "b", "-f", "c", "s", "d"};
+  EXPECT_EQ(args.size(), parse(args));
+  
+  ASSERT_EQ(5, events.size());
+  EXPECT_EQ(psr->dest_id("from"), events[0].dest);
+  EXPECT_EQ("a", values[0]);
+  EXPECT_EQ(2, events[0].index);
+  EXPECT_EQ(psr->dest_id("to"), events[1].dest);
+  EXPECT_EQ("b", values[1]);
+  EXPECT_EQ(psr->dest_id("from"), events[2].dest);
+  EXPECT_EQ("c", values[2]);
+  EXPECT_EQ(psr->dest_id("src"), events[3].dest);
+  EXPECT_EQ(psr->dest_id("dst"), events[4].dest);
+  EXPECT_EQ(8, events[4].index);
+  
+  // Values refer original arguments.
+  EXPECT_EQ(args[2].data(), events[0].value.data());
+  EXPECT_THROW(psr->dest_id("nothing"), argparse::exception::KeyError);
+}
+
+TEST_F(ParserEvents, actions) {
+  argparse::Argv args = {"./test", "-vwb", "1", "2", "--n=5", "-v", "s"};
+  parse(args);
+  
+  ASSERT_EQ(7, events.size());
+  EXPECT_EQ("v", events[0].arg->get_name());
+  EXPECT_EQ("", values[0]);
+  EXPECT_EQ("write", values[1]);
+  EXPECT_EQ("1", values[2]);
+  EXPECT_EQ(2, events[2].index);
+  EXPECT_EQ("2", values[3]);
+  EXPECT_EQ(3, events[3].index);
+  EXPECT_EQ("5", values[4]);
+  EXPECT_EQ(4, events[4].index);
+  EXPECT_EQ(psr->dest_id("v"), events[5].dest);
+  // Only one sequence argument goes to src, and dst is not set.
+  EXPECT_EQ(psr->dest_id("src"), events[6].dest);
+}
+
+TEST_F(ParserEvents, sequence_between_options) {
+  argparse::Argv args = {"./test", "s1", "-v", "s2", "-f", "x", "s3", "d"};
+  parse(args);
+  
+  ASSERT_EQ(6, events.size());
+  EXPECT_EQ(psr->dest_id("src"), events[0].dest);
+  EXPECT_EQ(psr->dest_id("src"), events[2].dest);
+  EXPECT_EQ("s2", values[2]);
+  EXPECT_EQ("x", values[3]);
+  EXPECT_EQ(psr->dest_id("src"), events[4].dest);
+  EXPECT_EQ("s3", values[4]);
+  EXPECT_EQ(psr->dest_id("dst"), events[5].dest);
+  EXPECT_EQ("d", values[5]);
+}
+
+TEST_F(ParserEvents, stop) {
+  argparse::Argv args = {"./test", "-v", "--version", "--unknown", "-n", "x"};
+  const argparse::ArgvView views(args.begin(), args.end());
+  const size_t version = psr->dest_id("version");
+  size_t count = 0;
+  
+  size_t idx = psr->parse_events(views, [&](const argparse::Event& ev) {
+      count++;
+      return (ev.dest != version);
+    });
+  // Errors after "--version" are not reported.
+  EXPECT_EQ(2, count);
+  EXPECT_EQ(3, idx);
+}
+
+TEST_F(ParserEvents, rest) {
+  argparse::Argv args = {"./test", "s", "d", "--", "-x", "y"};
+  EXPECT_EQ(4, parse(args));
+  EXPECT_EQ(2, events.size());
+}
+
+TEST_F(ParserEvents, main_argv) {
+  char *argv[] = {
+    const_cast<char*>("./test"), const_cast<char*>("-f"),
+    const_cast<char*>("a"), const_cast<char*>("s"), const_cast<char*>("d"),
+    nullptr,
+  };
+  size_t count = 0;
+  psr->parse_events(5, argv, [&](const argparse::Event& ev) {
+      EXPECT_EQ(argv[ev.index], ev.value.data());
+      count++;
+      return true;
+    });
+  EXPECT_EQ(3, count);
+}
+
+TEST_F(ParserEvents, same_errors_as_parse_args) {
+  psr->add_argument("-r").required(true);
+  
+  const std::vector<argparse::Argv> cases = {
+    {"./test", "-r", "x", "s", "d"},
+    {"./test", "-r", "x", "--unknown"},
+    {"./test", "-r", "x", "---x"},
+    {"./test", "-r", "x", "-n", "1", "-n", "2"},
+    {"./test", "-r", "x", "-n", "one"},
+    {"./test", "-r", "x", "--n=one"},
+    {"./test", "-r", "x", "-b", "1"},
+    {"./test", "-r", "x", "-b", "1", "-v"},
+    {"./test", "-r", "x", "--b=1"},
+    {"./test", "-r", "x", "--version=1"},
+    {"./test", "-r", "x", "-n"},
+    {"./test", "-r", "x", "s", "d", "e"},
+    {"./test", "s", "d"},
+    {"./test", "-r", "x", "s", "d", "--", "e"},
+  };
+  
+  for (const auto& args : cases) {
+    std::string expect, actual;
+    try {
+      psr->parse_args(args);
+    } catch (const argparse::exception::ParseError& e) {
+      expect = e.what();
+    }
+    try {
+      parse(args);
+    } catch (const argparse::exception::ParseError& e) {
+      actual = e.what();
+    }
+    EXPECT_EQ(expect, actual) << args.back();
+  }
+}
+
+TEST_F(ParserEvents, range) {
+  argparse::Argv args = {"./test", "-f", "a", "-t", "b", "-f", "c", "s", "d",
+                         "--", "x"};
+  const argparse::ArgvView views(args.begin(), args.end());
+  parse(args);
+  
+  size_t i = 0;
+  argparse::EventRange range = psr->events(views);
+  for (const auto& ev : range) {
+    ASSERT_LT(i, events.size());
+    EXPECT_EQ(events[i].dest, ev.dest);
+    EXPECT_EQ(events[i].arg, ev.arg);
+    EXPECT_EQ(events[i].index, ev.index);
+    EXPECT_EQ(events[i].value.data(), ev.value.data());
+    i++;
+  }
+  EXPECT_EQ(events.size(), i);
+  EXPECT_EQ(10, range.position());
+}
+
+TEST_F(ParserEvents, range_lazy) {
+  char *argv[] = {
+    const_cast<char*>("./test"), const_cast<char*>("-f"),
+    const_cast<char*>("a"), const_cast<char*>("-n"),
+    const_cast<char*>("x"), nullptr,
+  };
+  argparse::EventRange range = psr->events(5, argv);
+  auto it = range.begin();
+  ASSERT_TRUE(it != range.end());
+  EXPECT_EQ(argv[2], it->value.data());
+  // Error is found when the invalid argument is reached.
+  EXPECT_THROW(++it, argparse::exception::ParseError);
+}
+
+TEST_F(ParserEvents, range_empty) {
+  argparse::Argv args = {"./test"};
+  const argparse::ArgvView views(args.begin(), args.end());
+  argparse::EventRange range = psr->events(views);
+  EXPECT_TRUE(range.begin() == range.end());
+  EXPECT_EQ(1, range.position());
+}
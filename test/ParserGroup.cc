@@ -0,0 +1,176 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+class ParserGroup : public ::testing::Test {
+public:
+  argparse::Parser *psr1, *psr2;
+  argparse::ParserGroup *grp;
+  std::stringstream out;
+  virtual void SetUp() {
+    psr1 = new argparse::Parser("net");
+    psr1->add_argument("-p", "--port").type("int");
+    psr1->add_argument("-v").action("count");
+    psr1->add_argument("file").nargs("+");
+    psr1->set_output(&out);
+    
+    psr2 = new argparse::Parser("db");
+    psr2->add_argument("--db").set_default("x.db");
+    psr2->add_argument("-r").action("store_true");
+    psr2->set_output(&out);
+
+    grp = new argparse::ParserGroup();
+    grp->attach(*psr1);
+    grp->attach(*psr2);
+  }
+  
+  virtual void TearDown() {
+    delete grp;
+    delete psr1;
+    delete psr2;
+  }
+};
+
+TEST_F(ParserGroup, route) {
+  argparse::Argv seq = {"./test", "-vrv", "--port=80", "f1", "f2", "--db",
+                        "y.db", "--", "-x"};
+  std::vector<argparse::Values> vals = grp->parse_args(seq);
+  ASSERT_EQ(2, vals.size());
+  EXPECT_EQ(2, vals[0].to_int("v"));
+  EXPECT_EQ(80, vals[0].to_int("port"));
+  ASSERT_EQ(2, vals[0].size("file"));
+  EXPECT_FALSE(vals[0].is_set("db"));
+  EXPECT_EQ("y.db", vals[1]["db"]);
+  EXPECT_TRUE(vals[1].is_true("r"));
+  EXPECT_FALSE(vals[1].is_set("port"));
+  
+  EXPECT_EQ(1, vals[0].rest().size());
+  EXPECT_EQ(1, vals[1].rest().size());
+}
+
+TEST_F(ParserGroup, default_and_help) {
+  argparse::Argv seq1 = {"./test", "f1"};
+  std::vector<argparse::Values> v1 = grp->parse_args(seq1);
+  EXPECT_EQ("x.db", v1[1]["db"]);
+  EXPECT_FALSE(v1[1].is_true("r"));
+  
+  // "-h" is shared by all parsers and prints one help of all options.
+  argparse::Argv seq2 = {"./test", "-h"};
+  std::vector<argparse::Values> v2 = grp->parse_args(seq2);
+  EXPECT_TRUE(v2[0].is_help_mode());
+  EXPECT_TRUE(v2[1].is_help_mode());
+  const std::string help = out.str();
+  EXPECT_EQ(0, help.find("usage: net"));
+  EXPECT_EQ(std::string::npos, help.find("usage: db"));
+  EXPECT_EQ(help.find("usage:"), help.rfind("usage:"));
+  EXPECT_NE(std::string::npos, help.find("--port"));
+  EXPECT_NE(std::string::npos, help.find("--db"));
+  EXPECT_EQ(help.find("--help"), help.rfind("--help"));
+}
+
+TEST_F(ParserGroup, ng) {
+  argparse::Argv seq1 = {"./test", "--dbx", "f1"};
+  argparse::Argv seq2 = {"./test", "--port", "x", "f1"};
+  EXPECT_THROW(grp->parse_args(seq1), argparse::exception::ParseError);
+  EXPECT_THROW(grp->parse_args(seq2), argparse::exception::ParseError);
+}
+
+TEST_F(ParserGroup, conflict) {
+  argparse::Parser psr3("conflict");
+  psr3.add_argument("--port");
+  EXPECT_THROW(grp->attach(psr3), argparse::exception::ConfigureError);
+  // psr3 is not attached.
+  argparse::Argv seq = {"./test", "f1", "--port", "80"};
+  EXPECT_EQ(2, grp->parse_args(seq).size());
+}
+
+TEST_F(ParserGroup, sequence_conflict) {
+  argparse::Parser psr3("conflict");
+  psr3.add_argument("x");
+  EXPECT_THROW(grp->attach(psr3), argparse::exception::ConfigureError);
+  argparse::Argv seq = {"./test", "f1"};
+  EXPECT_EQ(2, grp->parse_args(seq).size());
+}
+
+TEST_F(ParserGroup, abbrev) {
+  argparse::Argv seq = {"./test", "--po", "80", "f1"};
+  EXPECT_THROW(grp->parse_args(seq), argparse::exception::ParseError);
+  
+  // Abbreviation is allowed only if all parsers allow it.
+  psr1->allow_abbrev(true);
+  EXPECT_THROW(grp->parse_args(seq), argparse::exception::ParseError);
+  psr2->allow_abbrev(true);
+  std::vector<argparse::Values> vals = grp->parse_args(seq);
+  EXPECT_EQ(80, vals[0].to_int("port"));
+  
+  psr2->add_argument("--pool");
+  argparse::Argv seq2 = {"./test", "--po", "80", "f1"};
+  try {
+    grp->parse_args(seq2);
+    FAIL();
+  } catch (argparse::exception::ParseError& e) {
+    EXPECT_EQ("ParseError: ambiguous option: --po could match "
+              "--pool, --port", std::string(e.what()));
+  }
+}
+
+TEST_F(ParserGroup, suggestion) {
+  argparse::Argv seq = {"./test", "--prt", "80", "f1"};
+  try {
+    grp->parse_args(seq);
+    FAIL();
+  } catch (argparse::exception::ParseError& e) {
+    ASSERT_EQ(1, e.suggestions().size());
+    EXPECT_EQ("--port", e.suggestions()[0]);
+  }
+}
+
+TEST_F(ParserGroup, add_after_attach) {
+  psr2->add_argument("--user");
+  argparse::Argv seq = {"./test", "--user", "u1", "f1"};
+  std::vector<argparse::Values> vals = grp->parse_args(seq);
+  EXPECT_EQ("u1", vals[1]["user"]);
+  
+  // A conflict made after attach() is found at parse.
+  psr2->add_argument("-v");
+  EXPECT_THROW(grp->parse_args(seq), argparse::exception::ConfigureError);
+}
+
+TEST_F(ParserGroup, complete) {
+  argparse::Argv seq = {"./test", "__complete", "1", "./test", "--d"};
+  std::vector<argparse::Values> vals = grp->parse_args(seq);
+  ASSERT_EQ(2, vals.size());
+  EXPECT_TRUE(vals[0].is_complete_mode());
+  EXPECT_TRUE(vals[1].is_complete_mode());
+  EXPECT_EQ("--db\n", out.str());
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+class ParserInlineValue : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->add_argument("-c", "--config");
+    psr->add_argument("--num").type("int");
+    psr->add_argument("--inc").action("append");
+    psr->add_argument("--files").nargs("*");
+    psr->add_argument("--point").nargs(2);
+    psr->add_argument("--flag").action("store_true");
+  }
+  
+  virtual void TearDown() { delete psr; }
+};
+
+TEST_F(ParserInlineValue, store) {
+  argparse::Argv seq = {"./test", "--config=prod.yml", "--num=0x10"};
+  argparse::Values val = psr->parse_args(seq);
+  EXPECT_EQ("prod.yml", val["config"]);
+  EXPECT_EQ(16, val.to_int("num"));
+}
+
+TEST_F(ParserInlineValue, split_at_first_equal) {
+  argparse::Argv seq1 = {"./test", "--config=a=b"};
+  EXPECT_EQ("a=b", psr->parse_args(seq1)["config"]);
+
+  argparse::Argv seq2 = {"./test", "--config="};
+  EXPECT_EQ("", psr->parse_args(seq2)["config"]);
+}
+
+TEST_F(ParserInlineValue, append) {
+  argparse::Argv seq = {"./test", "--inc=a", "--inc", "b", "--inc=-c"};
+  argparse::Values val = psr->parse_args(seq);
+  ASSERT_EQ(3, val.size("inc"));
+  EXPECT_EQ("a", val.get("inc", 0));
+  EXPECT_EQ("b", val.get("inc", 1));
+  EXPECT_EQ("-c", val.get("inc", 2));
+}
+
+TEST_F(ParserInlineValue, nargs) {
+  // Inline value is just one value as Python's argparse.
+  argparse::Argv seq1 = {"./test", "--files=f1", "--config", "c"};
+  argparse::Values val = psr->parse_args(seq1);
+  ASSERT_EQ(1, val.size("files"));
+  EXPECT_EQ("f1", val["files"]);
+  
+  argparse::Argv seq2 = {"./test", "--point=1", "2"};
+  EXPECT_THROW(psr->parse_args(seq2), argparse::exception::ParseError);
+}
+
+TEST_F(ParserInlineValue, ng) {
+  argparse::Argv seq1 = {"./test", "--flag=true"};
+  argparse::Argv seq2 = {"./test", "--num=x"};
+  argparse::Argv seq3 = {"./test", "--conf=x"};
+  EXPECT_THROW(psr->parse_args(seq1), argparse::exception::ParseError);
+  EXPECT_THROW(psr->parse_args(seq2), argparse::exception::ParseError);
+  EXPECT_THROW(psr->parse_args(seq3), argparse::exception::ParseError);
+}
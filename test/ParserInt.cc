@@ -0,0 +1,138 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+#include <map>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+
+class ParserInt : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->add_argument("-i", "--int32").type("int32").dest("i");
+    psr->add_argument("-l", "--int64").type("int64").dest("l");
+    psr->add_argument("-u", "--uint64").type("uint64").dest("u");
+    psr->add_argument("-n", "--int").type("int").dest("n");
+  }
+  virtual void TearDown() { delete psr; }
+
+  // Use "--opt=val" form because a negative value looks like an option.
+  argparse::Values parse(const std::string& opt, const std::string& val) {
+    static const std::map<std::string, std::string> names = {
+      {"-i", "--int32"}, {"-l", "--int64"}, {"-u", "--uint64"}, {"-n", "--int"},
+    };
+    return psr->parse_args(argparse::Argv({
+          "./test", names.at(opt) + "=" + val}));
+  }
+};
+
+TEST_F(ParserInt, int64) {
+  EXPECT_EQ(9223372036854775807LL,
+            parse("-l", "9223372036854775807").to_int64("l"));
+  EXPECT_EQ(INT64_MIN, parse("-l", "-9223372036854775808").to_int64("l"));
+  EXPECT_EQ(-5, parse("-l", "-5").to_int64("l"));
+  EXPECT_EQ(-5, parse("-l", "-5").to_int("l"));
+  EXPECT_EQ(-5, parse("-l", "-5").get<int64_t>("l"));
+  EXPECT_THROW(parse("-l", "9223372036854775808"),
+               argparse::exception::ParseError);
+  EXPECT_THROW(parse("-l", "-9223372036854775809"),
+               argparse::exception::ParseError);
+  EXPECT_THROW(parse("-l", "4294967296").to_int("l"),
+               argparse::exception::TypeError);
+  EXPECT_THROW(parse("-l", "-1").to_uint64("l"),
+               argparse::exception::TypeError);
+}
+
+TEST_F(ParserInt, uint64) {
+  EXPECT_EQ(18446744073709551615ULL,
+            parse("-u", "18446744073709551615").to_uint64("u"));
+  EXPECT_EQ(18446744073709551615ULL,
+            parse("-u", "0xffffffffffffffff").get<uint64_t>("u"));
+  EXPECT_EQ(0u, parse("-u", "-0").to_uint64("u"));
+  EXPECT_THROW(parse("-u", "18446744073709551616"),
+               argparse::exception::ParseError);
+  EXPECT_THROW(parse("-u", "-1"), argparse::exception::ParseError);
+  EXPECT_THROW(parse("-u", "18446744073709551615").to_int64("u"),
+               argparse::exception::TypeError);
+}
+
+TEST_F(ParserInt, int32) {
+  EXPECT_EQ(2147483647, parse("-i", "2147483647").to_int("i"));
+  EXPECT_EQ(-2147483647 - 1, parse("-i", "-2147483648").to_int("i"));
+  EXPECT_THROW(parse("-i", "2147483648"), argparse::exception::ParseError);
+  EXPECT_THROW(parse("-n", "-2147483649"), argparse::exception::ParseError);
+  EXPECT_EQ(7, parse("-n", "7").to_int64("n"));
+}
+
+TEST_F(ParserInt, prefix) {
+  EXPECT_EQ(255, parse("-l", "0xFF").to_int64("l"));
+  EXPECT_EQ(8, parse("-l", "0o10").to_int64("l"));
+  EXPECT_EQ(8, parse("-l", "010").to_int64("l"));
+  EXPECT_EQ(5, parse("-l", "0b101").to_int64("l"));
+  EXPECT_EQ(-16, parse("-l", "-0x10").to_int64("l"));
+  EXPECT_EQ(16, parse("-l", "+0x10").to_int64("l"));
+  EXPECT_EQ(0, parse("-l", "0").to_int64("l"));
+}
+
+TEST_F(ParserInt, invalid) {
+  const std::vector<std::string> invalid = {
+    "", "-", "+", "0x", "0b", "0b102", "08", "1.5", "12a", " 1", "1 ", "--1",
+  };
+  for (const auto& v : invalid) {
+    EXPECT_THROW(parse("-l", v), argparse::exception::ParseError) << v;
+    EXPECT_THROW(parse("-u", v), argparse::exception::ParseError) << v;
+  }
+}
+
+TEST_F(ParserInt, error_message) {
+  try {
+    parse("-l", "99999999999999999999");
+    FAIL();
+  } catch (const argparse::exception::ParseError& e) {
+    EXPECT_NE(std::string::npos, std::string(e.what()).find("Out of range"));
+  }
+  try {
+    parse("-l", "12x");
+    FAIL();
+  } catch (const argparse::exception::ParseError& e) {
+    EXPECT_NE(std::string::npos, std::string(e.what()).find("Invalid number"));
+  }
+}
+
+TEST_F(ParserInt, validate) {
+  argparse::ParseStatus st = psr->validate(argparse::Argv({
+        "./test", "-u", "18446744073709551616"}));
+  EXPECT_EQ(argparse::ErrorCode::invalid_value, st.code);
+  st = psr->validate(argparse::Argv({"./test", "--int64=-0x8000000000000000"}));
+  EXPECT_EQ(argparse::ErrorCode::none, st.code);
+}
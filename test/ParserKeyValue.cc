@@ -0,0 +1,134 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+
+class ParserKeyValue : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->add_argument("-D").action("append").key_value().dest("define");
+    psr->add_argument("--set").action("append")
+      .key_value(argparse::DupKey::first_wins);
+    psr->add_argument("--env").action("append")
+      .key_value(argparse::DupKey::error).set_default("HOME=/root");
+  }
+  virtual void TearDown() { delete psr; }
+  
+  static std::string find(const argparse::KeyValueMap& map,
+                          const std::string& key) {
+    const argparse::KeyValueMap::Entry *e = map.find(key);
+    return (e ? e->value.str() : "(none)");
+  }
+};
+
+TEST_F(ParserKeyValue, map) {
+  argparse::Values val = psr->parse_args(argparse::Argv({
+        "./test", "-D", "a=1", "-D", "b=2", "-D", "c=x=y", "-D", "empty=",
+        "-D", "a=3"}));
+  const argparse::KeyValueMap& def = val.get_map("define");
+  EXPECT_EQ(4u, def.size());
+  EXPECT_EQ("3", find(def, "a"));
+  EXPECT_EQ("2", find(def, "b"));
+  EXPECT_EQ("x=y", find(def, "c"));
+  EXPECT_EQ("", find(def, "empty"));
+  EXPECT_EQ("(none)", find(def, "d"));
+  EXPECT_EQ("(none)", find(def, "a="));
+  
+  // In order of keys given first.
+  std::vector<std::string> keys;
+  for (const auto& e : def) {
+    keys.push_back(e.key.str());
+  }
+  EXPECT_EQ(std::vector<std::string>({"a", "b", "c", "empty"}), keys);
+  
+  EXPECT_EQ("/root", find(val.get_map("env"), "HOME"));
+  EXPECT_THROW(val.get_map("set"), argparse::exception::KeyError);
+}
+
+TEST_F(ParserKeyValue, policy) {
+  argparse::Values val = psr->parse_args(argparse::Argv({
+        "./test", "--set", "a.b=c", "--set=a.b=d", "--env", "X=1"}));
+  EXPECT_EQ("c", find(val.get_map("set"), "a.b"));
+  EXPECT_EQ("1", find(val.get_map("env"), "X"));
+  EXPECT_EQ("(none)", find(val.get_map("env"), "HOME"));
+  
+  EXPECT_THROW(psr->parse_args(argparse::Argv({
+          "./test", "--env", "X=1", "--env", "X=2"})),
+               argparse::exception::ParseError);
+}
+
+TEST_F(ParserKeyValue, invalid) {
+  EXPECT_THROW(psr->parse_args(argparse::Argv({"./test", "-D", "abc"})),
+               argparse::exception::ParseError);
+  EXPECT_THROW(psr->parse_args(argparse::Argv({"./test", "-D", "=1"})),
+               argparse::exception::ParseError);
+  EXPECT_THROW(psr->parse_args(argparse::Argv({"./test", "-D"})),
+               argparse::exception::ParseError);
+  
+  argparse::ParseStatus st = psr->validate(argparse::Argv({
+        "./test", "-D", "a=1", "-D", "b"}));
+  EXPECT_EQ(argparse::ErrorCode::invalid_value, st.code);
+  EXPECT_EQ(4u, st.index);
+}
+
+TEST_F(ParserKeyValue, many) {
+  argparse::Argv args = {"./test"};
+  for (size_t i = 0; i < 5000; i++) {
+    args.push_back("-D");
+    args.push_back("key" + std::to_string(i) + "=" + std::to_string(i * 2));
+  }
+  args.push_back("-D");
+  args.push_back("key7=last");
+  argparse::Values val = psr->parse_args(args);
+  const argparse::KeyValueMap& def = val.get_map("define");
+  ASSERT_EQ(5000u, def.size());
+  for (size_t i = 0; i < 5000; i++) {
+    const std::string expected = (i == 7 ? "last" : std::to_string(i * 2));
+    EXPECT_EQ(expected, find(def, "key" + std::to_string(i)));
+  }
+  EXPECT_EQ(nullptr, def.find("key5000"));
+}
+
+TEST(ParserKeyValueConfig, consistency) {
+  argparse::Parser p1("test");
+  p1.add_argument("-D").key_value().nargs(2);
+  EXPECT_THROW(p1.parse_args(argparse::Argv({"./test"})),
+               argparse::exception::ConfigureError);
+  
+  argparse::Parser p2("test");
+  p2.add_argument("-D").key_value().split(',');
+  EXPECT_THROW(p2.parse_args(argparse::Argv({"./test"})),
+               argparse::exception::ConfigureError);
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+class ParserKnownArgs : public ::testing::Test {
+public:
+  argparse::Parser *psr1, *psr2;
+  virtual void SetUp() {
+    psr1 = new argparse::Parser("test");
+    psr1->add_argument("-v").action("store_true");
+    psr1->add_argument("--log");
+    psr1->add_argument("src");
+    
+    psr2 = new argparse::Parser("test");
+    psr2->add_argument("-q").action("store_true");
+    psr2->add_argument("--db");
+    psr2->add_argument("dst");
+  }
+  
+  virtual void TearDown() {
+    delete psr1;
+    delete psr2;
+  }
+};
+
+TEST_F(ParserKnownArgs, unknown_tokens) {
+  argparse::Argv seq = {"./test", "--db=x.db", "-v", "s", "-q", "--log", "l",
+                        "d"};
+  argparse::ArgvView unknown;
+  argparse::Values val = psr1->parse_known_args(seq, &unknown);
+  EXPECT_TRUE(val.is_true("v"));
+  EXPECT_EQ("s", val["src"]);
+  EXPECT_EQ("l", val["log"]);
+  
+  ASSERT_EQ(4, unknown.size());
+  EXPECT_EQ("./test", unknown[0].str());
+  EXPECT_EQ("--db=x.db", unknown[1].str());
+  EXPECT_EQ("-q", unknown[2].str());
+  EXPECT_EQ("d", unknown[3].str());
+  // Views refer strings of original arguments.
+  EXPECT_EQ(seq[1].data(), unknown[1].data());
+}
+
+TEST_F(ParserKnownArgs, chain) {
+  char *argv[] = {
+    const_cast<char*>("./test"), const_cast<char*>("-q"),
+    const_cast<char*>("--db=x.db"), const_cast<char*>("s"),
+    const_cast<char*>("d"), const_cast<char*>("-v"), nullptr,
+  };
+  argparse::ArgvView unknown1, unknown2;
+  argparse::Values v1 = psr1->parse_known_args(6, argv, &unknown1);
+  EXPECT_TRUE(v1.is_true("v"));
+  EXPECT_EQ("s", v1["src"]);
+  ASSERT_EQ(4, unknown1.size());
+  EXPECT_EQ(argv[0], unknown1[0].data());
+  EXPECT_EQ(argv[1], unknown1[1].data());
+  EXPECT_EQ(argv[2], unknown1[2].data());
+  EXPECT_EQ(argv[4], unknown1[3].data());
+  
+  argparse::Values v2 = psr2->parse_known_args(unknown1, &unknown2);
+  EXPECT_TRUE(v2.is_true("q"));
+  EXPECT_EQ("x.db", v2["db"]);
+  EXPECT_EQ("d", v2["dst"]);
+  ASSERT_EQ(1, unknown2.size());
+  EXPECT_EQ(argv[0], unknown2[0].data());
+}
+
+TEST_F(ParserKnownArgs, cluster) {
+  // "-vq" is unknown as a whole because psr1 does not know "-q".
+  argparse::Argv seq = {"./test", "-vq", "s"};
+  argparse::ArgvView unknown;
+  argparse::Values val = psr1->parse_known_args(seq, &unknown);
+  EXPECT_FALSE(val.is_true("v"));
+  ASSERT_EQ(2, unknown.size());
+  EXPECT_EQ("-vq", unknown[1].str());
+}
+
+TEST_F(ParserKnownArgs, error) {
+  // Required check and invalid format are still errors.
+  psr1->add_argument("-n").type("int").required(true);
+  argparse::ArgvView unknown;
+  argparse::Argv seq1 = {"./test", "s", "--db", "x"};
+  argparse::Argv seq2 = {"./test", "s", "-n", "x"};
+  EXPECT_THROW(psr1->parse_known_args(seq1, &unknown),
+               argparse::exception::ParseError);
+  EXPECT_THROW(psr1->parse_known_args(seq2, &unknown),
+               argparse::exception::ParseError);
+}
@@ -0,0 +1,226 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+
+class ParserLimits : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->add_argument("-v").action("count");
+    psr->add_argument("-i").action("append");
+    psr->add_argument("-f").nargs("*");
+    psr->add_argument("file").nargs("*");
+    
+    argparse::Limits limits;
+    limits.max_args = 8;
+    limits.max_bytes = 64;
+    limits.max_values = 3;
+    limits.max_cluster = 4;
+    psr->set_limits(limits);
+  }
+  
+  virtual void TearDown() { delete psr; }
+};
+
+TEST_F(ParserLimits, in_limits) {
+  argparse::Values val = psr->parse_args(argparse::Argv({
+        "./test", "-vvvv", "-i", "a", "-i", "b", "x", "y"}));
+  EXPECT_EQ(4, val.to_int("v"));
+  EXPECT_EQ("4", val.to_str("v"));
+  EXPECT_EQ(2, val.size("i"));
+  EXPECT_EQ(2, val.size("file"));
+  EXPECT_TRUE(psr->validate(argparse::Argv({"./test", "-vvvv"})).ok());
+}
+
+TEST_F(ParserLimits, max_args) {
+  argparse::Argv args = {"./test", "1", "2", "3", "-v", "-v", "6", "7", "8"};
+  EXPECT_THROW(psr->parse_args(args), argparse::exception::ParseError);
+  
+  argparse::ParseStatus st = psr->validate(args);
+  EXPECT_EQ(argparse::ErrorCode::limit_exceeded, st.code);
+  EXPECT_EQ(8, st.index);
+  
+  // argv of main() is rejected before building views of it.
+  char *argv[10] = {const_cast<char*>("./test")};
+  for (size_t i = 1; i < 9; i++) {
+    argv[i] = const_cast<char*>("-v");
+  }
+  EXPECT_THROW(psr->parse_args(9, argv), argparse::exception::ParseError);
+  EXPECT_EQ(argparse::ErrorCode::limit_exceeded,
+            psr->validate(9, argv).code);
+  EXPECT_NO_THROW(psr->parse_args(8, argv));
+}
+
+TEST_F(ParserLimits, max_bytes) {
+  const std::string large(60, 'x');
+  argparse::Argv args = {"./test", "-i", large};
+  EXPECT_THROW(psr->parse_args(args), argparse::exception::ParseError);
+  
+  argparse::ParseStatus st = psr->validate(args);
+  EXPECT_EQ(argparse::ErrorCode::limit_exceeded, st.code);
+  EXPECT_EQ(2, st.index);
+  
+  // argv of main() is measured only up to max_bytes, and arguments after
+  // the large one are not read.
+  std::string huge(1 << 20, 'x');
+  char *argv[4] = {const_cast<char*>("./test"), const_cast<char*>("-i"),
+                   &huge[0], nullptr};
+  EXPECT_THROW(psr->parse_args(4, argv), argparse::exception::ParseError);
+  EXPECT_THROW(psr->events(4, argv), argparse::exception::ParseError);
+  st = psr->validate(4, argv);
+  EXPECT_EQ(argparse::ErrorCode::limit_exceeded, st.code);
+  EXPECT_EQ(2, st.index);
+  
+  argv[2] = const_cast<char*>("x");
+  EXPECT_NO_THROW(psr->parse_args(3, argv));
+}
+
+TEST_F(ParserLimits, max_cluster) {
+  argparse::Argv args = {"./test", "-vvvvv"};
+  EXPECT_THROW(psr->parse_args(args), argparse::exception::ParseError);
+  EXPECT_EQ(argparse::ErrorCode::limit_exceeded, psr->validate(args).code);
+  
+  // Not an option after "--".
+  EXPECT_NO_THROW(psr->parse_args(argparse::Argv({"./test", "--",
+                                                  "-vvvvv"})));
+}
+
+TEST_F(ParserLimits, max_values) {
+  EXPECT_THROW(psr->parse_args(argparse::Argv({
+          "./test", "-i", "a", "-i", "b", "-i", "c", "-i", "d"})),
+    argparse::exception::ParseError);
+  EXPECT_THROW(psr->parse_args(argparse::Argv({
+          "./test", "-f", "a", "b", "c", "d"})),
+    argparse::exception::ParseError);
+  EXPECT_THROW(psr->parse_args(argparse::Argv({
+          "./test", "a", "b", "c", "d"})),
+    argparse::exception::ParseError);
+  
+  argparse::ParseStatus st = psr->validate(argparse::Argv({
+        "./test", "-f", "a", "b", "c", "d"}));
+  EXPECT_EQ(argparse::ErrorCode::limit_exceeded, st.code);
+  EXPECT_EQ(5, st.index);
+}
+
+TEST_F(ParserLimits, push_parser) {
+  argparse::PushParser pp(*psr);
+  pp.feed("-vv");
+  EXPECT_THROW(pp.feed("-vvvvv"), argparse::exception::ParseError);
+  
+  argparse::PushParser pp2(*psr);
+  for (size_t i = 0; i < 3; i++) {
+    pp2.feed("-i");
+    pp2.feed("x");
+  }
+  pp2.feed("-i");
+  EXPECT_THROW(pp2.feed("x"), argparse::exception::ParseError);
+}
+
+TEST_F(ParserLimits, parser_group) {
+  argparse::Parser psr2("test2");
+  psr2.add_argument("--name");
+  
+  argparse::ParserGroup group;
+  group.attach(*psr);
+  group.attach(psr2);
+  EXPECT_NO_THROW(group.parse_args(argparse::Argv({"./test", "-vvvv",
+                                                   "--name", "x"})));
+  EXPECT_THROW(group.parse_args(argparse::Argv({"./test", "-vvvvv",
+                                                "--name", "x"})),
+               argparse::exception::ParseError);
+  
+  // argc of main() is checked as Parser::parse_args, including arguments
+  // after "--".
+  char *argv[10] = {const_cast<char*>("./test"), const_cast<char*>("--")};
+  for (size_t i = 2; i < 9; i++) {
+    argv[i] = const_cast<char*>("x");
+  }
+  EXPECT_THROW(group.parse_args(9, argv), argparse::exception::ParseError);
+  EXPECT_NO_THROW(group.parse_args(8, argv));
+}
+
+TEST_F(ParserLimits, parser_group_strictest) {
+  argparse::Parser psr2("test2");
+  psr2.add_argument("--name");
+  argparse::Limits limits;
+  limits.max_args = 4;
+  psr2.set_limits(limits);
+  
+  // max_args of psr2 and max_cluster of psr are both applied.
+  argparse::ParserGroup group;
+  group.attach(*psr);
+  group.attach(psr2);
+  EXPECT_NO_THROW(group.parse_args(argparse::Argv({"./test", "-vvvv",
+                                                   "--name", "x"})));
+  EXPECT_THROW(group.parse_args(argparse::Argv({"./test", "-v", "-v",
+                                                "--name", "x"})),
+               argparse::exception::ParseError);
+  EXPECT_THROW(group.parse_args(argparse::Argv({"./test", "-vvvvv"})),
+               argparse::exception::ParseError);
+}
+
+TEST_F(ParserLimits, split_items) {
+  argparse::Parser p("test");
+  p.add_argument("--ff").split(',').action("append");
+  argparse::Limits limits;
+  limits.max_values = 2;
+  p.set_limits(limits);
+  
+  EXPECT_NO_THROW(p.parse_args(argparse::Argv({"./test", "--ff", "a,b"})));
+  argparse::Argv args = {"./test", "--ff", "a,b,c,d,e"};
+  EXPECT_THROW(p.parse_args(args), argparse::exception::ParseError);
+  EXPECT_EQ(argparse::ErrorCode::limit_exceeded, p.validate(args).code);
+  
+  args = {"./test", "--ff", "a", "--ff", "b,c"};
+  EXPECT_THROW(p.parse_args(args), argparse::exception::ParseError);
+  EXPECT_EQ(argparse::ErrorCode::limit_exceeded, p.validate(args).code);
+}
+
+TEST_F(ParserLimits, key_value_entries) {
+  argparse::Parser p("test");
+  p.add_argument("-D").action("append").key_value();
+  argparse::Limits limits;
+  limits.max_values = 2;
+  p.set_limits(limits);
+  
+  argparse::Argv args = {"./test", "-D", "a=1", "-D", "b=2", "-D", "c=3"};
+  EXPECT_THROW(p.parse_args(args), argparse::exception::ParseError);
+  EXPECT_EQ(argparse::ErrorCode::limit_exceeded, p.validate(args).code);
+  
+  // A duplicated key replaces the entry.
+  args = {"./test", "-D", "a=1", "-D", "b=2", "-D", "a=3"};
+  EXPECT_EQ(2u, p.parse_args(args).size("D"));
+  EXPECT_TRUE(p.validate(args).ok());
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+
+class ParserNet : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->add_argument("--ip").type("ip").action("append");
+    psr->add_argument("--v4").type("ipv4");
+    psr->add_argument("--v6").type("ipv6");
+    psr->add_argument("--allow").type("cidr").action("append");
+    psr->add_argument("--ports").type("ports");
+    psr->add_argument("--mac").type("mac");
+  }
+  virtual void TearDown() { delete psr; }
+  
+  argparse::Values parse(const argparse::Argv& args) {
+    argparse::Argv argv = {"./test"};
+    argv.insert(argv.end(), args.begin(), args.end());
+    return psr->parse_args(argv);
+  }
+  
+  static argparse::IPAddress ip(const std::string& v) {
+    argparse::IPAddress addr;
+    EXPECT_TRUE(argparse::IPAddress::parse(v, &addr)) << v;
+    return addr;
+  }
+};
+
+TEST_F(ParserNet, ipv4) {
+  argparse::Values val = parse({"--v4", "192.168.0.1"});
+  const argparse::IPAddress& addr = val.to_ip("v4");
+  EXPECT_TRUE(addr.is_v4());
+  EXPECT_EQ(0xc0a80001u, addr.v4());
+  EXPECT_EQ("192.168.0.1", val["v4"]);
+  
+  EXPECT_EQ(0u, parse({"--v4", "0.0.0.0"}).to_ip("v4").v4());
+  EXPECT_EQ(0xffffffffu, parse({"--v4", "255.255.255.255"}).to_ip("v4").v4());
+  
+  EXPECT_THROW(parse({"--v4", "256.0.0.1"}), argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--v4", "1.2.3"}), argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--v4", "1.2.3.4.5"}), argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--v4", "01.2.3.4"}), argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--v4", "1..3.4"}), argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--v4", "::1"}), argparse::exception::ParseError);
+}
+
+TEST_F(ParserNet, ipv6) {
+  const argparse::IPAddress& lo = parse({"--v6", "::1"}).to_ip("v6");
+  for (size_t i = 0; i < 15; i++) {
+    EXPECT_EQ(0, lo.bytes[i]);
+  }
+  EXPECT_EQ(1, lo.bytes[15]);
+  EXPECT_FALSE(lo.is_v4());
+  
+  EXPECT_EQ(ip("fe80:0:0:0:0:0:0:1"), ip("fe80::1"));
+  EXPECT_EQ(ip("2001:db8:0:0:1:0:0:1"), ip("2001:DB8::1:0:0:1"));
+  EXPECT_EQ(ip("1:2:3:4:5:6:7:0"), ip("1:2:3:4:5:6:7::"));
+  EXPECT_EQ(ip("0:0:0:0:0:0:0:0"), ip("::"));
+  EXPECT_EQ(ip("10.0.0.1"), ip("::ffff:10.0.0.1"));
+  EXPECT_EQ(0xa000001u, ip("::ffff:a00:1").v4());
+  
+  EXPECT_THROW(parse({"--v6", "1::2::3"}), argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--v6", ":1:2:3:4:5:6:7"}),
+               argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--v6", "1:2:3:4:5:6:7"}),
+               argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--v6", "1:2:3:4:5:6:7:8:9"}),
+               argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--v6", "1:2:3:4:5:6:7:8::"}),
+               argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--v6", "12345::"}), argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--v6", "1:"}), argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--v6", "g::1"}), argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--v6", "10.0.0.1"}), argparse::exception::ParseError);
+}
+
+TEST_F(ParserNet, ip_list) {
+  argparse::Values val = parse({"--ip", "10.0.0.1", "--ip", "fe80::1",
+                                "--ip", "10.0.0.2"});
+  std::vector<argparse::IPAddress> ips = val.to_ips("ip");
+  ASSERT_EQ(3u, ips.size());
+  EXPECT_EQ(ip("10.0.0.1"), ips[0]);
+  EXPECT_EQ(ip("fe80::1"), ips[1]);
+  EXPECT_EQ(ip("10.0.0.2"), ips[2]);
+  EXPECT_TRUE(ips[0] < ips[2]);
+  EXPECT_EQ(&val.get<argparse::IPAddress>("ip", 1), &val.to_ip("ip", 1));
+  EXPECT_THROW(val.to_int("ip"), argparse::exception::TypeError);
+}
+
+TEST_F(ParserNet, cidr) {
+  argparse::Values val = parse({"--allow", "10.0.0.0/8,192.168.1.0/24",
+                                "--allow", "fe80::/10", "--allow", "1.2.3.4"});
+  const argparse::CidrTable& table = val.to_cidrs("allow");
+  ASSERT_EQ(4u, table.cidrs().size());
+  EXPECT_EQ(8, table.cidrs()[0].length);
+  EXPECT_EQ(10, table.cidrs()[2].length);
+  EXPECT_EQ(32, table.cidrs()[3].length);
+  EXPECT_EQ(4u, val.size("allow"));
+  EXPECT_EQ("10.0.0.0/8,192.168.1.0/24,fe80::/10,1.2.3.4", val["allow"]);
+  
+  EXPECT_TRUE(table.contains(ip("10.0.0.0")));
+  EXPECT_TRUE(table.contains(ip("10.255.255.255")));
+  EXPECT_FALSE(table.contains(ip("11.0.0.0")));
+  EXPECT_FALSE(table.contains(ip("9.255.255.255")));
+  EXPECT_TRUE(table.contains(ip("192.168.1.77")));
+  EXPECT_FALSE(table.contains(ip("192.168.2.1")));
+  EXPECT_TRUE(table.contains(ip("1.2.3.4")));
+  EXPECT_FALSE(table.contains(ip("1.2.3.5")));
+  EXPECT_TRUE(table.contains(ip("fe80::1")));
+  EXPECT_TRUE(table.contains(ip("febf:ffff::")));
+  EXPECT_FALSE(table.contains(ip("fec0::")));
+  EXPECT_FALSE(table.contains(ip("::1")));
+  // IPv4 blocks are not matched with IPv6 addresses of same bits.
+  EXPECT_FALSE(table.contains(ip("::a00:1")));
+}
+
+TEST_F(ParserNet, cidr_merge) {
+  argparse::Values val = parse({"--allow",
+                                "10.0.1.0/24,10.0.0.0/24,10.0.0.128/25,"
+                                "10.0.2.0/23,10.0.5.0/24"});
+  const argparse::CidrTable& table = val.to_cidrs("allow");
+  EXPECT_EQ(5u, table.cidrs().size());
+  // 10.0.0.0-10.0.3.255 and 10.0.5.0-10.0.5.255
+  EXPECT_EQ(2u, table.intervals());
+  EXPECT_TRUE(table.contains(ip("10.0.3.255")));
+  EXPECT_FALSE(table.contains(ip("10.0.4.0")));
+  EXPECT_TRUE(table.contains(ip("10.0.5.0")));
+  
+  // Host bits are cleared.
+  argparse::Values host = parse({"--allow", "10.1.2.3/16"});
+  EXPECT_EQ(ip("10.1.0.0"), host.to_cidrs("allow").cidrs()[0].addr);
+  
+  argparse::Values all = parse({"--allow", "0.0.0.0/0,::/0"});
+  EXPECT_EQ(1u, all.to_cidrs("allow").intervals());
+  EXPECT_TRUE(all.to_cidrs("allow").contains(ip("ffff::")));
+}
+
+TEST_F(ParserNet, cidr_error) {
+  EXPECT_THROW(parse({"--allow", "10.0.0.0/33"}),
+               argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--allow", "fe80::/129"}),
+               argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--allow", "10.0.0.0/"}),
+               argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--allow", "10.0.0.0/8,"}),
+               argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--allow", "10.0.0.0/8", "--allow", "x/8"}),
+               argparse::exception::ParseError);
+  
+  argparse::Parser p("test");
+  p.add_argument("--net").type("cidr").nargs("+");
+  EXPECT_THROW(p.parse_args(argparse::Argv({"./test", "--net", "::/0"})),
+               argparse::exception::ConfigureError);
+}
+
+TEST_F(ParserNet, ports) {
+  argparse::Values val = parse({"--ports", "22,80,8000-8080"});
+  const argparse::IntRanges& ports = val.to_ranges("ports");
+  EXPECT_TRUE(ports.contains(22));
+  EXPECT_TRUE(ports.contains(8042));
+  EXPECT_FALSE(ports.contains(443));
+  
+  EXPECT_NO_THROW(parse({"--ports", "0-65535"}));
+  EXPECT_THROW(parse({"--ports", "65536"}), argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--ports=-1"}), argparse::exception::ParseError);
+}
+
+TEST_F(ParserNet, mac) {
+  argparse::Values val = parse({"--mac", "00:1A:2b:3c:4D:ff"});
+  const argparse::MacAddr& mac = val.get<argparse::MacAddr>("mac");
+  const uint8_t expected[6] = {0x00, 0x1a, 0x2b, 0x3c, 0x4d, 0xff};
+  EXPECT_EQ(0, memcmp(expected, mac.bytes, 6));
+  EXPECT_EQ(mac, parse({"--mac", "00-1a-2b-3c-4d-ff"})
+            .get<argparse::MacAddr>("mac"));
+  
+  EXPECT_THROW(parse({"--mac", "00:1a:2b:3c:4d"}),
+               argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--mac", "00:1a-2b:3c:4d:ff"}),
+               argparse::exception::ParseError);
+  EXPECT_THROW(parse({"--mac", "00:1a:2b:3c:4d:fg"}),
+               argparse::exception::ParseError);
+}
+
+TEST_F(ParserNet, validate) {
+  EXPECT_TRUE(psr->validate(argparse::Argv({"./test", "--v4", "1.2.3.4",
+                                            "--allow", "::/0"})).ok());
+  EXPECT_FALSE(psr->validate(argparse::Argv({"./test", "--v4",
+                                             "1.2.3.4.5"})).ok());
+  EXPECT_FALSE(psr->validate(argparse::Argv({"./test", "--allow",
+                                             "10/8"})).ok());
+  EXPECT_FALSE(psr->validate(argparse::Argv({"./test", "--mac",
+                                             "aa"})).ok());
+}
+
+TEST_F(ParserNet, cidr_limits) {
+  argparse::Limits limits;
+  limits.max_values = 2;
+  psr->set_limits(limits);
+  argparse::Argv args = {"./test", "--allow", "10.0.0.0/8",
+                         "--allow", "10.1.0.0/16,10.2.0.0/16"};
+  EXPECT_THROW(psr->parse_args(args), argparse::exception::ParseError);
+  EXPECT_EQ(argparse::ErrorCode::limit_exceeded, psr->validate(args).code);
+  
+  args.resize(3);
+  EXPECT_NO_THROW(psr->parse_args(args));
+  EXPECT_TRUE(psr->validate(args).ok());
+}
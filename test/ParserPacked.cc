@@ -0,0 +1,164 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+
+class ParserPacked : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->add_argument("--ids").type("int64").nargs("+").packed(true);
+    psr->add_argument("-s", "--shard").type("int").action("append")
+      .packed(true);
+    psr->add_argument("--port").type("int").nargs("*").packed(true)
+      .set_default("80");
+    psr->add_argument("nums").type("int").nargs("*").packed(true);
+  }
+  virtual void TearDown() { delete psr; }
+};
+
+TEST_F(ParserPacked, nargs) {
+  argparse::Values val = psr->parse_args(argparse::Argv({
+        "./test", "--ids", "1", "0x10", "12345678901234567", "9", "-s", "3"}));
+  ASSERT_EQ(4u, val.size("ids"));
+  argparse::Int64Span ids = val.to_int64s("ids");
+  const std::vector<int64_t> expected = {1, 16, 12345678901234567LL, 9};
+  EXPECT_EQ(expected, std::vector<int64_t>(ids.begin(), ids.end()));
+  EXPECT_EQ(expected, val.get<std::vector<int64_t>>("ids"));
+  
+  EXPECT_EQ(1u, val.to_int64s("port").size());
+  EXPECT_EQ(80, val.to_int64s("port")[0]);
+  EXPECT_THROW(val.get("ids"), argparse::exception::TypeError);
+  EXPECT_THROW(val.to_int64s("nums"), argparse::exception::KeyError);
+}
+
+TEST_F(ParserPacked, append) {
+  argparse::Values val = psr->parse_args(argparse::Argv({
+        "./test", "-s", "1", "--shard=-2", "-s", "3", "4", "5", "6"}));
+  argparse::Int64Span shard = val.to_int64s("shard");
+  ASSERT_EQ(3u, shard.size());
+  EXPECT_EQ(1, shard[0]);
+  EXPECT_EQ(-2, shard[1]);
+  EXPECT_EQ(3, shard[2]);
+  
+  argparse::Int64Span nums = val.to_int64s("nums");
+  ASSERT_EQ(3u, nums.size());
+  EXPECT_EQ(4, nums[0]);
+  EXPECT_EQ(6, nums[2]);
+}
+
+TEST_F(ParserPacked, invalid) {
+  EXPECT_THROW(psr->parse_args(argparse::Argv({
+          "./test", "--ids", "1", "x"})), argparse::exception::ParseError);
+  EXPECT_THROW(psr->parse_args(argparse::Argv({
+          "./test", "-s", "2147483648"})), argparse::exception::ParseError);
+  EXPECT_THROW(psr->parse_args(argparse::Argv({"./test", "--ids"})),
+               argparse::exception::ParseError);
+}
+
+TEST_F(ParserPacked, not_packed) {
+  psr->add_argument("-n").type("int").nargs("+");
+  argparse::Values val = psr->parse_args(argparse::Argv({
+        "./test", "-n", "1", "2"}));
+  EXPECT_THROW(val.to_int64s("n"), argparse::exception::TypeError);
+}
+
+TEST_F(ParserPacked, limits) {
+  argparse::Limits lim;
+  lim.max_values = 3;
+  psr->set_limits(lim);
+  EXPECT_NO_THROW(psr->parse_args(argparse::Argv({
+          "./test", "--ids", "1", "2", "3"})));
+  EXPECT_THROW(psr->parse_args(argparse::Argv({
+          "./test", "--ids", "1", "2", "3", "4"})),
+               argparse::exception::ParseError);
+}
+
+TEST_F(ParserPacked, push_parser) {
+  argparse::PushParser push(*psr);
+  for (auto t : {"-s", "7", "--ids", "5", "6", "-s", "8"}) {
+    push.feed(t);
+  }
+  argparse::Values val = push.finish();
+  EXPECT_EQ(2u, val.to_int64s("ids").size());
+  ASSERT_EQ(2u, val.to_int64s("shard").size());
+  EXPECT_EQ(8, val.to_int64s("shard")[1]);
+}
+
+TEST(ParserPackedConfig, consistency) {
+  argparse::Parser p1("test");
+  p1.add_argument("-a").nargs("+").packed(true);
+  EXPECT_THROW(p1.parse_args(argparse::Argv({"./test"})),
+               argparse::exception::ConfigureError);
+  
+  argparse::Parser p2("test");
+  p2.add_argument("-a").type("int").nargs("?").packed(true);
+  EXPECT_THROW(p2.parse_args(argparse::Argv({"./test"})),
+               argparse::exception::ConfigureError);
+  
+  argparse::Parser p3("test");
+  p3.add_argument("-a").type("uint64").nargs("+").packed(true);
+  EXPECT_THROW(p3.parse_args(argparse::Argv({"./test"})),
+               argparse::exception::ConfigureError);
+}
+
+TEST(ParserPackedSwar, same_as_scalar) {
+  // Decimal values of 1 to 19 digits through the SWAR path and others.
+  const std::vector<std::string> valid = {
+    "0", "7", "12345678", "123456789", "9999999999999999", "10000000000000000",
+    "9223372036854775807", "-9223372036854775808", "00", "000000017",
+  };
+  const std::vector<int64_t> expected = {
+    0, 7, 12345678, 123456789, 9999999999999999LL, 10000000000000000LL,
+    INT64_MAX, INT64_MIN, 0, 15,
+  };
+  for (size_t i = 0; i < valid.size(); i++) {
+    int64_t v = -1;
+    EXPECT_EQ(argparse_internal::Var::NumResult::ok,
+              argparse_internal::Var::parse_int(valid[i], INT64_MIN, INT64_MAX,
+                                                &v)) << valid[i];
+    EXPECT_EQ(expected[i], v) << valid[i];
+  }
+  
+  const std::vector<std::string> invalid = {
+    "1234567/", "1234567:", "12345678a", "/2345678", "123456789012345:",
+    "1 2", "١",
+  };
+  for (const auto& v : invalid) {
+    int64_t n;
+    EXPECT_EQ(argparse_internal::Var::NumResult::invalid,
+              argparse_internal::Var::parse_int(v, INT64_MIN, INT64_MAX, &n))
+      << v;
+  }
+}
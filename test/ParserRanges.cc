@@ -0,0 +1,164 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+
+class ParserRanges : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->add_argument("--cpus").type("int_ranges").set_default("0");
+    psr->add_argument("--ids").type("int_ranges");
+  }
+  virtual void TearDown() { delete psr; }
+  
+  const argparse::IntRanges& parse(const std::string& v) {
+    val_.reset(new argparse::Values(psr->parse_args(argparse::Argv({
+              "./test", "--ids=" + v}))));
+    return val_->to_ranges("ids");
+  }
+  
+  std::vector<int64_t> values(const std::string& v) {
+    const argparse::IntRanges& r = parse(v);
+    return std::vector<int64_t>(r.begin(), r.end());
+  }
+  
+private:
+  std::unique_ptr<argparse::Values> val_;
+};
+
+TEST_F(ParserRanges, parse) {
+  EXPECT_EQ(std::vector<int64_t>({0, 1, 2, 3, 8, 9}), values("0-3,8-9"));
+  EXPECT_EQ(std::vector<int64_t>({1, 3, 5, 7}), values("1..8:2"));
+  EXPECT_EQ(std::vector<int64_t>({-3, -2, -1}), values("-3--1"));
+  EXPECT_EQ(std::vector<int64_t>({-2, 0, 5}), values("5,-2..0:2"));
+  EXPECT_EQ(std::vector<int64_t>({16, 17}), values("0x10-0x11"));
+  EXPECT_EQ(std::vector<int64_t>({7}), values("7"));
+  EXPECT_EQ(std::vector<int64_t>({7}), values("7..7:3"));
+  
+  argparse::Values val = psr->parse_args(argparse::Argv({"./test"}));
+  EXPECT_TRUE(val.to_ranges("cpus").contains(0));
+  EXPECT_EQ("0", val["cpus"]);
+}
+
+TEST_F(ParserRanges, merge) {
+  const argparse::IntRanges& r = parse("32-47,0-15,16-20,10-12,3,100..200:10,"
+                                       "110");
+  ASSERT_EQ(3u, r.ranges().size());
+  EXPECT_EQ(0, r.ranges()[0].first);
+  EXPECT_EQ(20, r.ranges()[0].last);
+  EXPECT_EQ(32, r.ranges()[1].first);
+  EXPECT_EQ(47, r.ranges()[1].last);
+  EXPECT_EQ(10, r.ranges()[2].step);
+}
+
+TEST_F(ParserRanges, overlap) {
+  EXPECT_THROW(parse("1..9:2,2..8:2"), argparse::exception::ParseError);
+  EXPECT_NO_THROW(parse("1..9:2,5"));
+  EXPECT_NO_THROW(parse("1..9:2,3..7:4"));
+  EXPECT_NO_THROW(parse("0-100,10..20:2"));
+}
+
+TEST_F(ParserRanges, split_stepped) {
+  // A value not in the stepped range splits it.
+  const argparse::IntRanges& r1 = parse("1..10:2,4");
+  ASSERT_EQ(3u, r1.ranges().size());
+  EXPECT_EQ(3, r1.ranges()[0].last);
+  EXPECT_EQ(4, r1.ranges()[1].first);
+  EXPECT_EQ(5, r1.ranges()[2].first);
+  EXPECT_TRUE(r1.contains(4));
+  EXPECT_TRUE(r1.contains(5));
+  EXPECT_FALSE(r1.contains(6));
+  EXPECT_EQ(std::vector<int64_t>({1, 3, 4, 5, 7, 9}), values("1..10:2,4"));
+  
+  const argparse::IntRanges& r2 = parse("100..200:10,150-300");
+  std::vector<int64_t> v2(r2.begin(), r2.end());
+  ASSERT_EQ(156u, v2.size());
+  EXPECT_EQ(140, v2[4]);
+  EXPECT_EQ(150, v2[5]);
+  EXPECT_TRUE(r2.contains(155));
+  EXPECT_FALSE(r2.contains(145));
+  
+  // A stepped range over a range of step 1 keeps values after it.
+  EXPECT_EQ(std::vector<int64_t>({1, 3, 4, 5, 6, 7, 10}),
+            values("3-5,1..11:3,6"));
+  EXPECT_EQ(std::vector<int64_t>({0, 1, 2, 4, 8}), values("0..8:4,0-2,8"));
+}
+
+TEST_F(ParserRanges, contains) {
+  const argparse::IntRanges& r = parse("1..1000000:2,2000000-3000000,-5");
+  EXPECT_TRUE(r.contains(1));
+  EXPECT_TRUE(r.contains(999999));
+  EXPECT_FALSE(r.contains(1000000));
+  EXPECT_FALSE(r.contains(2));
+  EXPECT_FALSE(r.contains(0));
+  EXPECT_TRUE(r.contains(-5));
+  EXPECT_FALSE(r.contains(-4));
+  EXPECT_TRUE(r.contains(2000000));
+  EXPECT_TRUE(r.contains(3000000));
+  EXPECT_FALSE(r.contains(3000001));
+  EXPECT_FALSE(r.contains(INT64_MIN));
+  EXPECT_EQ(3u, r.ranges().size());
+}
+
+TEST_F(ParserRanges, huge) {
+  const argparse::IntRanges& r = parse(
+    "-9223372036854775808..9223372036854775807:3");
+  ASSERT_EQ(1u, r.ranges().size());
+  EXPECT_TRUE(r.contains(INT64_MIN));
+  EXPECT_TRUE(r.contains(INT64_MIN + 3));
+  EXPECT_FALSE(r.contains(INT64_MIN + 1));
+  EXPECT_EQ(INT64_MIN + 3 * (UINT64_MAX / 3), r.ranges()[0].last);
+  
+  const argparse::IntRanges& all = parse("-9223372036854775808-"
+                                         "9223372036854775807");
+  EXPECT_TRUE(all.contains(INT64_MAX));
+  EXPECT_TRUE(all.contains(0));
+}
+
+TEST_F(ParserRanges, invalid) {
+  const std::vector<std::string> invalid = {
+    "", ",", "1,", ",1", "1,,2", "a", "1-", "-", "1..", "..2", "1-2-3",
+    "5-1", "1..5:0", "1..5:-1", "1:2", "1-5:", "1 - 5",
+  };
+  for (const auto& v : invalid) {
+    EXPECT_THROW(parse(v), argparse::exception::ParseError) << v;
+    if (! v.empty()) {  // validate() does not check an empty value
+      EXPECT_FALSE(psr->validate(argparse::Argv({
+              "./test", "--ids=" + v})).ok()) << v;
+    }
+  }
+  EXPECT_THROW(parse("0-9223372036854775808"),
+               argparse::exception::ParseError);
+}
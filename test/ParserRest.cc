@@ -0,0 +1,97 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+class ParserRest : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->add_argument("-v").action("store_true");
+    psr->add_argument("-f").nargs("*");
+    psr->add_argument("cmd").nargs("?");
+  }
+  
+  virtual void TearDown() { delete psr; }
+};
+
+TEST_F(ParserRest, argv) {
+  argparse::Argv seq = {"./test", "-v", "--", "ls", "-l", "--", "x"};
+  argparse::Values val = psr->parse_args(seq);
+  EXPECT_TRUE(val.is_true("v"));
+  EXPECT_FALSE(val.is_set("cmd"));
+  
+  const argparse::ArgvSpan& rest = val.rest();
+  ASSERT_EQ(4, rest.size());
+  EXPECT_STREQ("ls", rest[0]);
+  EXPECT_STREQ("-l", rest[1]);
+  EXPECT_STREQ("--", rest[2]);
+  EXPECT_STREQ("x", rest[3]);
+  EXPECT_EQ(nullptr, rest.argv()[4]);
+}
+
+TEST_F(ParserRest, main_argv) {
+  char *argv[] = {
+    const_cast<char*>("./test"), const_cast<char*>("-f"),
+    const_cast<char*>("a"), const_cast<char*>("b"), const_cast<char*>("--"),
+    const_cast<char*>("ls"), const_cast<char*>("-l"), nullptr,
+  };
+  argparse::Values val = psr->parse_args(7, argv);
+  EXPECT_EQ(2, val.size("f"));
+  
+  // Refers original argv without copy, then can be passed to execve(2).
+  const argparse::ArgvSpan& rest = val.rest();
+  EXPECT_EQ(2, rest.size());
+  EXPECT_EQ(argv + 5, rest.argv());
+  EXPECT_EQ(nullptr, rest.argv()[rest.size()]);
+  
+  size_t n = 0;
+  for (auto arg : rest) {
+    EXPECT_EQ(argv[5 + n], arg);
+    n++;
+  }
+  EXPECT_EQ(2, n);
+}
+
+TEST_F(ParserRest, empty) {
+  argparse::Argv seq1 = {"./test", "c"};
+  argparse::Values v1 = psr->parse_args(seq1);
+  EXPECT_EQ("c", v1["cmd"]);
+  EXPECT_TRUE(v1.rest().empty());
+  EXPECT_EQ(nullptr, v1.rest().argv()[0]);
+  
+  argparse::Argv seq2 = {"./test", "--"};
+  argparse::Values v2 = psr->parse_args(seq2);
+  EXPECT_TRUE(v2.rest().empty());
+  EXPECT_EQ(nullptr, v2.rest().argv()[0]);
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+TEST(ParserSequence, src_dst) {
+  argparse::Parser psr("test");
+  psr.add_argument("src").nargs("+");
+  psr.add_argument("dst");
+  psr.add_argument("-v").action("store_true");
+  
+  argparse::Argv seq1 = {"./test", "a", "b", "c", "d"};
+  argparse::Values v1 = psr.parse_args(seq1);
+  ASSERT_EQ(3, v1.size("src"));
+  EXPECT_EQ("a", v1.get("src", 0));
+  EXPECT_EQ("c", v1.get("src", 2));
+  EXPECT_EQ("d", v1["dst"]);
+  
+  // Options and sequence arguments can be intermixed.
+  argparse::Argv seq2 = {"./test", "a", "-v", "b"};
+  argparse::Values v2 = psr.parse_args(seq2);
+  ASSERT_EQ(1, v2.size("src"));
+  EXPECT_EQ("a", v2["src"]);
+  EXPECT_EQ("b", v2["dst"]);
+  EXPECT_TRUE(v2.is_true("v"));
+  
+  // Not enough arguments are kept unset as before.
+  argparse::Argv seq3 = {"./test", "a"};
+  argparse::Values v3 = psr.parse_args(seq3);
+  EXPECT_EQ("a", v3["src"]);
+  EXPECT_FALSE(v3.is_set("dst"));
+}
+
+TEST(ParserSequence, mixed_nargs) {
+  argparse::Parser psr("test");
+  psr.add_argument("a").nargs("?");
+  psr.add_argument("b").nargs("*");
+  psr.add_argument("c").nargs(2);
+  psr.add_argument("d").nargs("+");
+  
+  argparse::Argv seq1 = {"./test", "c1", "c2", "d1"};
+  argparse::Values v1 = psr.parse_args(seq1);
+  EXPECT_FALSE(v1.is_set("a"));
+  EXPECT_FALSE(v1.is_set("b"));
+  EXPECT_EQ(2, v1.size("c"));
+  EXPECT_EQ(1, v1.size("d"));
+  
+  argparse::Argv seq2 = {"./test", "a1", "b1", "b2", "c1", "c2", "d1"};
+  argparse::Values v2 = psr.parse_args(seq2);
+  EXPECT_EQ("a1", v2["a"]);
+  EXPECT_EQ(2, v2.size("b"));
+  EXPECT_EQ("c1", v2.get("c", 0));
+  EXPECT_EQ("d1", v2["d"]);
+  
+  // Earlier arguments are greedy.
+  argparse::Argv seq3 = {"./test", "a1", "c1", "c2", "d1", "d2"};
+  argparse::Values v3 = psr.parse_args(seq3);
+  EXPECT_EQ("a1", v3["a"]);
+  EXPECT_EQ(1, v3.size("b"));
+  EXPECT_EQ("c1", v3["b"]);
+  EXPECT_EQ("c2", v3.get("c", 0));
+  EXPECT_EQ("d1", v3.get("c", 1));
+  EXPECT_EQ(1, v3.size("d"));
+  
+  argparse::Argv seq4 = {"./test", "c1"};
+  EXPECT_THROW(psr.parse_args(seq4), argparse::exception::ParseError);
+}
+
+TEST(ParserSequence, extra) {
+  argparse::Parser psr("test");
+  psr.add_argument("a");
+  psr.add_argument("-x").action("store_true");
+  
+  argparse::Argv seq = {"./test", "a1", "-y", "a2", "-x", "a3"};
+  EXPECT_THROW(psr.parse_args(seq), argparse::exception::ParseError);
+  
+  argparse::ArgvView unknown;
+  argparse::Values val = psr.parse_known_args(seq, &unknown);
+  EXPECT_EQ("a1", val["a"]);
+  EXPECT_TRUE(val.is_true("x"));
+  ASSERT_EQ(4, unknown.size());
+  EXPECT_EQ("-y", unknown[1].str());
+  EXPECT_EQ("a2", unknown[2].str());
+  EXPECT_EQ("a3", unknown[3].str());
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+
+class ParserSplit : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->add_argument("--enable-features").action("append").split(',')
+      .dest("features");
+    psr->add_argument("--mode").split(':').choices({"r", "w", "x"})
+      .set_default("r:w");
+    psr->add_argument("-l", "--langs").action("append").split(',')
+      .choices({"c", "cpp", "go", "rust"});
+  }
+  virtual void TearDown() { delete psr; }
+  
+  static std::vector<std::string> items(const argparse::SplitList& list) {
+    std::vector<std::string> res;
+    for (auto v : list) {
+      res.push_back(v.str());
+    }
+    return res;
+  }
+};
+
+TEST_F(ParserSplit, split) {
+  argparse::Values val = psr->parse_args(argparse::Argv({
+        "./test", "--enable-features=a,b,,c", "--enable-features", "d,e,",
+        "--enable-features=f"}));
+  const argparse::SplitList& list = val.to_list("features");
+  EXPECT_EQ(std::vector<std::string>({"a", "b", "c", "d", "e", "f"}),
+            items(list));
+  ASSERT_EQ(6u, list.size());
+  EXPECT_EQ("c", list[2].str());
+  EXPECT_EQ("a,b,,c,d,e,,f", val["features"]);
+  EXPECT_EQ(6u, val.size("features"));
+}
+
+TEST_F(ParserSplit, empty) {
+  argparse::Values val = psr->parse_args(argparse::Argv({
+        "./test", "--enable-features=", "--enable-features=,"}));
+  EXPECT_TRUE(val.to_list("features").empty());
+  
+  EXPECT_THROW(psr->parse_args(argparse::Argv({
+          "./test", "--enable-features"})), argparse::exception::ParseError);
+}
+
+TEST_F(ParserSplit, choices) {
+  argparse::Values val = psr->parse_args(argparse::Argv({
+        "./test", "-l", "go,c", "--langs=rust,go"}));
+  const argparse::SplitList& langs = val.to_list("langs");
+  EXPECT_EQ(std::vector<std::string>({"go", "c", "rust", "go"}), items(langs));
+  EXPECT_TRUE(langs.has_choice(0));
+  EXPECT_FALSE(langs.has_choice(1));
+  EXPECT_TRUE(langs.has_choice(2));
+  EXPECT_TRUE(langs.has_choice(3));
+  EXPECT_FALSE(langs.has_choice(100));
+  ASSERT_EQ(1u, langs.choice_bits().size());
+  EXPECT_EQ(0xDu, langs.choice_bits()[0]);
+  
+  const argparse::SplitList& mode = val.to_list("mode");
+  EXPECT_EQ(std::vector<std::string>({"r", "w"}), items(mode));
+  EXPECT_EQ(0x3u, mode.choice_bits()[0]);
+  
+  EXPECT_THROW(psr->parse_args(argparse::Argv({"./test", "-l", "go,java"})),
+               argparse::exception::ParseError);
+  EXPECT_THROW(psr->parse_args(argparse::Argv({"./test", "--mode=r:a"})),
+               argparse::exception::ParseError);
+}
+
+TEST_F(ParserSplit, validate) {
+  EXPECT_TRUE(psr->validate(argparse::Argv({
+          "./test", "-l", "go,c", "--mode=x"})).ok());
+  argparse::ParseStatus st = psr->validate(argparse::Argv({
+        "./test", "-l", "go,c", "-l", "go,java"}));
+  EXPECT_EQ(argparse::ErrorCode::invalid_choice, st.code);
+  EXPECT_EQ(4u, st.index);
+}
+
+TEST_F(ParserSplit, push_parser) {
+  argparse::PushParser push(*psr);
+  for (auto t : {"-l", "go", "--enable-features=a,b", "-l", "c,cpp"}) {
+    push.feed(t);
+  }
+  argparse::Values val = push.finish();
+  EXPECT_EQ(std::vector<std::string>({"go", "c", "cpp"}),
+            items(val.to_list("langs")));
+  EXPECT_EQ(std::vector<std::string>({"a", "b"}),
+            items(val.to_list("features")));
+}
+
+TEST(ParserSplitConfig, consistency) {
+  argparse::Parser p1("test");
+  p1.add_argument("-a").split(',').nargs("+");
+  EXPECT_THROW(p1.parse_args(argparse::Argv({"./test"})),
+               argparse::exception::ConfigureError);
+  
+  argparse::Parser p2("test");
+  p2.add_argument("-a").split(',').type("int");
+  EXPECT_THROW(p2.parse_args(argparse::Argv({"./test"})),
+               argparse::exception::ConfigureError);
+  
+  argparse::Parser p3("test");
+  p3.add_argument("-a").split(',').choices({"x", "y"}).set_default("x,z");
+  EXPECT_THROW(p3.parse_args(argparse::Argv({"./test"})),
+               argparse::exception::ConfigureError);
+}
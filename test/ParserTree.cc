@@ -0,0 +1,115 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+#include <sstream>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+
+class ParserTree : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->add_argument("--db.host").set_default("localhost").help("host");
+    psr->add_argument("--db.pool.size").type("int").set_default("8")
+      .help("pool size");
+    psr->add_argument("--db.pool.timeout").type("duration").help("timeout");
+    psr->add_argument("--dbx").help("not in db");
+    psr->add_argument("--cache.size").type("size").help("cache size");
+    psr->add_argument("-v").action("store_true").help("verbose");
+  }
+  virtual void TearDown() { delete psr; }
+};
+
+TEST_F(ParserTree, subtree) {
+  argparse::Values val = psr->parse_args(argparse::Argv({
+        "./test", "--db.pool.timeout=5s", "--dbx", "x", "--cache.size=1K"}));
+  
+  argparse::Values db = val.subtree("db");
+  EXPECT_EQ("localhost", db["host"]);
+  EXPECT_EQ(std::vector<std::string>({"host", "pool.size", "pool.timeout"}),
+            db.keys());
+  
+  argparse::Values pool = db.subtree("pool");
+  EXPECT_EQ(8, pool.to_int("size"));
+  EXPECT_EQ(5000000000ULL, pool.to_uint64("timeout"));
+  EXPECT_TRUE(pool.is_set("size"));
+  EXPECT_FALSE(pool.is_set("host"));
+  EXPECT_EQ(std::vector<std::string>({"size", "timeout"}), pool.keys());
+  EXPECT_THROW(pool["host"], argparse::exception::KeyError);
+  
+  // Same as subtree of full prefix, and values are shared.
+  EXPECT_EQ(pool.keys(), val.subtree("db.pool").keys());
+  EXPECT_EQ(1024u, val.subtree("cache").to_uint64("size"));
+  EXPECT_TRUE(val.subtree("none").keys().empty());
+  
+  // All dests of root.
+  EXPECT_EQ(std::vector<std::string>({
+        "cache.size", "db.host", "db.pool.size", "db.pool.timeout", "dbx",
+        "v"}), val.keys());
+}
+
+TEST_F(ParserTree, copy) {
+  argparse::Values val = psr->parse_args(argparse::Argv({"./test"}));
+  argparse::Values pool = val.subtree("db").subtree("pool");
+  argparse::Values copy(pool);
+  EXPECT_EQ(8, copy.to_int("size"));
+  copy = val;
+  EXPECT_EQ("localhost", copy["db.host"]);
+}
+
+TEST_F(ParserTree, help) {
+  std::stringstream out;
+  psr->set_output(&out);
+  psr->help();
+  const std::string help = out.str();
+  
+  const size_t opt = help.find("optional arguments:\n");
+  const size_t cache = help.find("\ncache:\n");
+  const size_t db = help.find("\ndb:\n");
+  const size_t pool = help.find("\ndb.pool:\n");
+  ASSERT_NE(std::string::npos, opt);
+  ASSERT_NE(std::string::npos, cache);
+  ASSERT_NE(std::string::npos, db);
+  ASSERT_NE(std::string::npos, pool);
+  EXPECT_LT(opt, cache);
+  EXPECT_LT(cache, db);
+  EXPECT_LT(db, pool);
+  
+  // Options without dot stay in optional arguments.
+  EXPECT_LT(help.find("--dbx", opt), cache);
+  EXPECT_LT(help.find("  -v", opt), cache);
+  EXPECT_GT(help.find("--db.host", opt), db);
+  EXPECT_LT(help.find("--db.host", opt), pool);
+  EXPECT_GT(help.find("--db.pool.size", opt), pool);
+  EXPECT_GT(help.find("--db.pool.timeout", opt), pool);
+}
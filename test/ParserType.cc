@@ -0,0 +1,181 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+
+#include <stdexcept>
+
+struct Duration {
+  int64_t msec;
+};
+
+static Duration to_duration(const std::string& val) {
+  size_t pos;
+  Duration d = {std::stoll(val, &pos)};
+  const std::string unit = val.substr(pos);
+  if (unit == "s") {
+    d.msec *= 1000;
+  } else if (unit != "ms") {
+    throw std::invalid_argument("unit must be s or ms");
+  }
+  return d;
+}
+
+enum class Color { red, green };
+
+class ParserType : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->add_argument("-t", "--timeout").type<Duration>(to_duration)
+      .set_default("3s");
+    psr->add_argument("-i", "--interval").action("append")
+      .type<Duration>(to_duration);
+    psr->add_argument("-c").type<Color>([](const std::string& v) {
+        return (v == "red" ? Color::red : Color::green);
+      }).choices({"red", "green"});
+    psr->add_argument("-n").type("int");
+    psr->add_argument("-b").type("bool");
+    psr->add_argument("name");
+  }
+  
+  virtual void TearDown() { delete psr; }
+};
+
+TEST_F(ParserType, get) {
+  argparse::Values val = psr->parse_args(argparse::Argv({
+        "./test", "-i", "10ms", "--interval=2s", "-c", "green", "-n", "5",
+        "-b", "true", "x"}));
+  
+  EXPECT_EQ(3000, val.get<Duration>("timeout").msec);
+  EXPECT_EQ("3s", val.get("timeout"));
+  ASSERT_EQ(2, val.size("interval"));
+  EXPECT_EQ(10, val.get<Duration>("interval", 0).msec);
+  EXPECT_EQ(2000, val.get<Duration>("interval", 1).msec);
+  EXPECT_EQ(Color::green, val.get<Color>("c"));
+  EXPECT_EQ(1, val.to_index("c"));
+  
+  // Built-in types.
+  EXPECT_EQ(5, val.get<int>("n"));
+  EXPECT_TRUE(val.get<bool>("b"));
+  EXPECT_EQ("x", val.get<std::string>("name"));
+}
+
+TEST_F(ParserType, type_error) {
+  argparse::Values val = psr->parse_args(argparse::Argv({
+        "./test", "-n", "5", "x"}));
+  EXPECT_THROW(val.get<Duration>("n"), argparse::exception::TypeError);
+  EXPECT_THROW(val.get<int>("timeout"), argparse::exception::TypeError);
+  EXPECT_THROW(val.get<int>("name"), argparse::exception::TypeError);
+}
+
+TEST_F(ParserType, invalid_value) {
+  EXPECT_THROW(psr->parse_args(argparse::Argv({"./test", "-t", "3h", "x"})),
+               argparse::exception::ParseError);
+  EXPECT_THROW(psr->parse_args(argparse::Argv({"./test", "-t", "s", "x"})),
+               argparse::exception::ParseError);
+  EXPECT_THROW(psr->parse_args(argparse::Argv({"./test", "-c", "blue", "x"})),
+               argparse::exception::ParseError);
+  
+  // validate() does not call converters, but parse_events() does.
+  argparse::Argv args = {"./test", "-i", "1s", "-i", "3h", "x"};
+  EXPECT_TRUE(psr->validate(args).ok());
+  const argparse::ArgvView views(args.begin(), args.end());
+  EXPECT_THROW(psr->parse_events(views, [](const argparse::Event& ev) {
+        return true;
+      }), argparse::exception::ParseError);
+  
+  argparse::ParseStatus st = psr->validate(argparse::Argv({"./test", "-c", "blue", "x"}));
+  EXPECT_EQ(argparse::ErrorCode::invalid_choice, st.code);
+}
+
+TEST_F(ParserType, configure_error) {
+  argparse::Parser p("test");
+  p.add_argument("-a").action("store_true").type<int>([](const std::string&) {
+      return 1;
+    });
+  EXPECT_THROW(p.parse_args(argparse::Argv({"./test"})),
+               argparse::exception::ConfigureError);
+}
+
+TEST_F(ParserType, array) {
+  argparse::Values val = psr->parse_args(argparse::Argv({
+        "./test", "-i", "10ms", "-i", "2s", "-i", "5ms", "x"}));
+  
+  // All values of a dest are in one std::vector.
+  const std::vector<Duration>& all = val.get<std::vector<Duration>>("interval");
+  ASSERT_EQ(3u, all.size());
+  EXPECT_EQ(2000, all[1].msec);
+  EXPECT_EQ(&all[2], &val.get<Duration>("interval", 2));
+  EXPECT_EQ("5ms", val.get("interval", 2));
+  EXPECT_THROW(val.get<Duration>("interval", 3),
+               argparse::exception::IndexError);
+  EXPECT_THROW(val.get<std::vector<int>>("interval"),
+               argparse::exception::TypeError);
+}
+
+TEST_F(ParserType, str_view) {
+  argparse::Parser p("test");
+  p.add_argument("-s").nargs("*")
+    .type<size_t>([](const argparse::StrView& v) { return v.size(); });
+  p.add_argument("-q").nargs("?").set_const("abc")
+    .type<size_t>([](const argparse::StrView& v) { return v.size(); });
+  
+  argparse::Values val = p.parse_args(argparse::Argv({
+        "./test", "-s", "a", "bcd", "-q"}));
+  EXPECT_EQ(std::vector<size_t>({1, 3}), val.get<std::vector<size_t>>("s"));
+  EXPECT_EQ(3u, val.get<size_t>("q"));
+  EXPECT_EQ("abc", val.get("q"));
+  
+  val = p.parse_args(argparse::Argv({"./test", "-s"}));
+  EXPECT_EQ(0u, val.size("s"));
+  EXPECT_TRUE(val.get<std::vector<size_t>>("s").empty());
+}
+
+TEST_F(ParserType, rollback) {
+  argparse::Parser p("test");
+  p.add_argument("-d").nargs(2).type<Duration>(to_duration);
+  argparse::PushParser push(p);
+  
+  push.feed("-d");
+  push.feed("1s");
+  EXPECT_THROW(push.feed("3h"), argparse::exception::ParseError);
+  EXPECT_THROW(p.parse_args(argparse::Argv({"./test", "-d", "1s", "3h"})),
+               argparse::exception::ParseError);
+  
+  argparse::Parser q("test");
+  q.add_argument("-q").nargs("?").type<Duration>(to_duration);
+  EXPECT_THROW(q.parse_args(argparse::Argv({"./test"})),
+               argparse::exception::ConfigureError);
+}
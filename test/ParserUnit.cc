@@ -0,0 +1,130 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+#include <chrono>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+
+class ParserUnit : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->add_argument("--cache-size").type("size").set_default("64M");
+    psr->add_argument("--timeout").type("duration").set_default("30s");
+  }
+  virtual void TearDown() { delete psr; }
+  
+  uint64_t size(const std::string& v) {
+    return psr->parse_args(argparse::Argv({"./test", "--cache-size=" + v}))
+      .to_uint64("cache-size");
+  }
+  uint64_t duration(const std::string& v) {
+    return psr->parse_args(argparse::Argv({"./test", "--timeout=" + v}))
+      .get<uint64_t>("timeout");
+  }
+};
+
+TEST_F(ParserUnit, size) {
+  EXPECT_EQ(512u, size("512"));
+  EXPECT_EQ(512u, size("512B"));
+  EXPECT_EQ(4ULL << 30, size("4G"));
+  EXPECT_EQ(4ULL << 30, size("4g"));
+  EXPECT_EQ(4ULL << 30, size("4GiB"));
+  EXPECT_EQ(4000000000ULL, size("4GB"));
+  EXPECT_EQ(1536u, size("1.5K"));
+  EXPECT_EQ(102u, size("0.1K"));  // 102.4 is rounded down
+  EXPECT_EQ(1000000000000ULL, size("1TB"));
+  EXPECT_EQ(1ULL << 50, size("1P"));
+  EXPECT_EQ(15ULL << 60, size("15360P"));
+  // Units are case insensitive.
+  EXPECT_EQ(4096u, size("4k"));
+  EXPECT_EQ(4000u, size("4kb"));
+  EXPECT_EQ(4000u, size("4Kb"));
+  EXPECT_EQ(4096u, size("4kib"));
+  EXPECT_EQ(4096u, size("4KIB"));
+  EXPECT_EQ(12u, size("12b"));
+  
+  argparse::Values val = psr->parse_args(argparse::Argv({"./test"}));
+  EXPECT_EQ(64ULL << 20, val.to_uint64("cache-size"));
+  EXPECT_EQ("64M", val["cache-size"]);
+}
+
+TEST_F(ParserUnit, size_invalid) {
+  const std::vector<std::string> invalid = {
+    "", "K", ".", "1X", "1KK", "1KBB", "1kbb", "1Ki", "1ki", "-1", "+1",
+    "1 K", "1.K.", "1\xC4", "1K\xE9",
+  };
+  for (const auto& v : invalid) {
+    EXPECT_THROW(size(v), argparse::exception::ParseError) << v;
+  }
+  EXPECT_THROW(size("16384P"), argparse::exception::ParseError);
+  EXPECT_THROW(size("18446744073709551616"), argparse::exception::ParseError);
+  EXPECT_EQ(18446744073709551615ULL, size("18446744073709551615"));
+}
+
+TEST_F(ParserUnit, duration) {
+  EXPECT_EQ(250000000u, duration("250ms"));
+  EXPECT_EQ(5400000000000ULL, duration("1h30m"));
+  EXPECT_EQ(2500000000ULL, duration("2.5s"));
+  EXPECT_EQ(1500u, duration("1.5us"));
+  EXPECT_EQ(1500u, duration("1.5\xC2\xB5s"));
+  EXPECT_EQ(7u, duration("7ns"));
+  EXPECT_EQ(86400000000000ULL + 1, duration("1d1ns"));
+  EXPECT_EQ(0u, duration("0"));
+  
+  argparse::Values val = psr->parse_args(argparse::Argv({"./test"}));
+  EXPECT_EQ(std::chrono::seconds(30), val.to_duration("timeout"));
+}
+
+TEST_F(ParserUnit, duration_invalid) {
+  const std::vector<std::string> invalid = {
+    "", "1", "s", "1x", "1h30", "-1s", "1.s.", "1 s", "10S", "0s ",
+  };
+  for (const auto& v : invalid) {
+    EXPECT_THROW(duration(v), argparse::exception::ParseError) << v;
+  }
+  EXPECT_THROW(duration("213504d"), argparse::exception::ParseError);
+  EXPECT_EQ(213503ULL * 86400000000000ULL, duration("213503d"));
+  
+  // Over range of std::chrono::nanoseconds.
+  argparse::Values val = psr->parse_args(argparse::Argv({
+        "./test", "--timeout=150000d"}));
+  EXPECT_THROW(val.to_duration("timeout"), argparse::exception::TypeError);
+}
+
+TEST_F(ParserUnit, validate) {
+  EXPECT_TRUE(psr->validate(argparse::Argv({
+          "./test", "--timeout=1m30s", "--cache-size=2KiB"})).ok());
+  EXPECT_EQ(argparse::ErrorCode::invalid_value,
+            psr->validate(argparse::Argv({"./test", "--timeout=1m30"})).code);
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+
+class ParserValidate : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->add_argument("-n", "--num").type("int");
+    psr->add_argument("-b").nargs(2);
+    psr->add_argument("-v").action("count");
+    psr->add_argument("-r", "--read").action("store_true");
+    psr->add_argument("--required").required(true);
+    psr->add_argument("src").nargs("+");
+    psr->add_argument("dst");
+  }
+  
+  virtual void TearDown() { delete psr; }
+  
+  argparse::ParseStatus validate(const argparse::Argv& args) {
+    return psr->validate(args);
+  }
+};
+
+TEST_F(ParserValidate, ok) {
+  argparse::ParseStatus st = validate({"./test", "--required", "x", "-vv",
+                                       "-n", "3", "s1", "s2", "d"});
+  EXPECT_TRUE(st.ok());
+  EXPECT_EQ(argparse::ErrorCode::none, st.code);
+  EXPECT_TRUE(validate({"./test", "--required=x", "--", "-z"}).ok());
+}
+
+TEST_F(ParserValidate, errors) {
+  argparse::ParseStatus st;
+  
+  st = validate({"./test", "--required", "x", "--unknown"});
+  EXPECT_EQ(argparse::ErrorCode::unknown_option, st.code);
+  EXPECT_EQ(3, st.index);
+  EXPECT_EQ(nullptr, st.arg);
+  
+  st = validate({"./test", "--required", "x", "-n", "x1"});
+  EXPECT_EQ(argparse::ErrorCode::invalid_value, st.code);
+  EXPECT_EQ(4, st.index);
+  EXPECT_EQ("num", st.arg->get_dest());
+  
+  st = validate({"./test", "--required", "x", "-b", "1", "-v"});
+  EXPECT_EQ(argparse::ErrorCode::missing_value, st.code);
+  EXPECT_EQ(3, st.index);
+  
+  st = validate({"./test", "--required", "x", "-n", "1", "--num", "2"});
+  EXPECT_EQ(argparse::ErrorCode::duplicated_option, st.code);
+  EXPECT_EQ(5, st.index);
+  
+  st = validate({"./test", "--required", "x", "--read=1"});
+  EXPECT_EQ(argparse::ErrorCode::unexpected_value, st.code);
+  
+  st = validate({"./test", "--required", "x", "---x"});
+  EXPECT_EQ(argparse::ErrorCode::bad_hyphen, st.code);
+  
+  argparse::Parser psr2("test");
+  psr2.add_argument("file");
+  st = psr2.validate(argparse::Argv({"./test", "a", "b"}));
+  EXPECT_EQ(argparse::ErrorCode::extra_argument, st.code);
+  EXPECT_EQ(2, st.index);
+  
+  st = validate({"./test", "s", "d"});
+  EXPECT_EQ(argparse::ErrorCode::missing_required, st.code);
+  EXPECT_EQ(3, st.index);
+  EXPECT_EQ("required", st.arg->get_name());
+}
+
+TEST_F(ParserValidate, ambiguous) {
+  psr->add_argument("--reader");
+  psr->allow_abbrev(true);
+  argparse::ParseStatus st = validate({"./test", "--required", "x", "--rea"});
+  EXPECT_EQ(argparse::ErrorCode::ambiguous_option, st.code);
+  EXPECT_EQ(3, st.index);
+}
+
+TEST_F(ParserValidate, error_message) {
+  argparse::Argv args = {"./test", "--required", "x", "--nmu", "1"};
+  const argparse::ArgvView views(args.begin(), args.end());
+  EXPECT_FALSE(psr->validate(views).ok());
+  std::string expect;
+  try {
+    psr->parse_args(args);
+  } catch (const argparse::exception::ParseError& e) {
+    expect = e.what();
+  }
+  EXPECT_EQ(expect, psr->error_message(views));
+  
+  argparse::Argv valid = {"./test", "--required", "x"};
+  const argparse::ArgvView views2(valid.begin(), valid.end());
+  EXPECT_EQ("", psr->error_message(views2));
+}
+
+TEST_F(ParserValidate, main_argv) {
+  char *argv[] = {
+    const_cast<char*>("./test"), const_cast<char*>("--required"),
+    const_cast<char*>("x"), const_cast<char*>("-n"), const_cast<char*>("1"),
+    nullptr,
+  };
+  EXPECT_TRUE(psr->validate(5, argv).ok());
+  EXPECT_EQ(argparse::ErrorCode::missing_value, psr->validate(4, argv).code);
+}
+
+TEST(ParserValidateSeq, short_nargs) {
+  argparse::Parser psr("test");
+  psr.add_argument("a");
+  psr.add_argument("b").nargs(2);
+  argparse::Argv args = {"t", "x", "y"};
+  const argparse::ArgvView views(args.begin(), args.end());
+  EXPECT_THROW(psr.parse_args(args), argparse::exception::ParseError);
+  argparse::ParseStatus st = psr.validate(views);
+  EXPECT_EQ(argparse::ErrorCode::missing_value, st.code);
+  EXPECT_EQ("b", st.arg->get_name());
+  EXPECT_NE("", psr.error_message(views));
+  
+  args.push_back("z");
+  EXPECT_NO_THROW(psr.parse_args(args));
+  EXPECT_TRUE(psr.validate(args).ok());
+}
+
+TEST(ParserValidateType, same_as_parse) {
+  argparse::Parser psr("test");
+  psr.add_argument("--hex").type("hex");
+  psr.add_argument("--b64").type("base64");
+  psr.add_argument("--cidr").type("cidr");
+  psr.add_argument("--ports").type("ports");
+  psr.add_argument("--ids").type("int_ranges");
+  
+  const std::vector<argparse::Argv> cases = {
+    {"./test", "--hex", "0xdeadBEEF"}, {"./test", "--hex", "0xdeadBEEG"},
+    {"./test", "--hex", "abc"}, {"./test", "--hex", "0x"},
+    {"./test", "--b64", "aGVsbG8="}, {"./test", "--b64", "aGVsbG9="},
+    {"./test", "--b64", "aGV*bG8="}, {"./test", "--b64", "aGVsbA=="},
+    {"./test", "--cidr", "10.0.0.0/8,::1"}, {"./test", "--cidr", "10.0/8"},
+    {"./test", "--cidr", "10.0.0.0/33"},
+    {"./test", "--ports", "80,1000-2000"}, {"./test", "--ports", "65536"},
+    {"./test", "--ports", "-1"}, {"./test", "--ids", "1..10:2,4"},
+    {"./test", "--ids", "1..9:2,2..8:2"}, {"./test", "--ids", "1..9:2,3..7:4"},
+    {"./test", "--ids", "5-1"},
+  };
+  for (const auto& args : cases) {
+    bool parsed = true;
+    try {
+      psr.parse_args(args);
+    } catch (const argparse::exception::ParseError& e) {
+      parsed = false;
+    }
+    EXPECT_EQ(parsed, psr.validate(args).ok()) << args[2];
+  }
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2016, Masayoshi Mizutani, mizutani@sfc.wide.ad.jp
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <vector>
+#include <string>
+
+#include "./gtest.h"
+#include "../argparse.hpp"
+
+class PushParser : public ::testing::Test {
+public:
+  argparse::Parser *psr;
+  virtual void SetUp() {
+    psr = new argparse::Parser("test");
+    psr->add_argument("-a").action("store_true");
+    psr->add_argument("-b").nargs(2);
+    psr->add_argument("-c", "--count").action("count");
+    psr->add_argument("-n", "--name");
+    psr->add_argument("-i").action("append");
+    psr->add_argument("src").nargs("+");
+    psr->add_argument("dst");
+  }
+  
+  virtual void TearDown() { delete psr; }
+};
+
+TEST_F(PushParser, basic) {
+  argparse::PushParser pp(*psr);
+  for (auto& arg : argparse::Argv({"-ab", "x", "y", "s1", "--name=foo",
+                                   "-cc", "s2", "-i", "i1", "-i", "i2",
+                                   "d"})) {
+    pp.feed(arg);
+  }
+  argparse::Values val = pp.finish();
+  
+  EXPECT_TRUE(val.is_true("a"));
+  ASSERT_EQ(2, val.size("b"));
+  EXPECT_EQ("x", val.get("b", 0));
+  EXPECT_EQ("y", val.get("b", 1));
+  EXPECT_EQ("foo", val["name"]);
+  EXPECT_EQ(2, val.to_int("count"));
+  ASSERT_EQ(2, val.size("i"));
+  EXPECT_EQ("i2", val.get("i", 1));
+  ASSERT_EQ(2, val.size("src"));
+  EXPECT_EQ("s1", val.get("src", 0));
+  EXPECT_EQ("s2", val.get("src", 1));
+  EXPECT_EQ("d", val["dst"]);
+}
+
+TEST_F(PushParser, same_as_batch) {
+  argparse::Argv args = {"s1", "-n", "v", "s2", "-b", "1", "2", "d"};
+  argparse::PushParser pp(*psr);
+  for (auto& arg : args) {
+    pp.feed(arg);
+  }
+  argparse::Values v1 = pp.finish();
+  
+  args.insert(args.begin(), "./test");
+  argparse::Values v2 = psr->parse_args(args);
+  
+  EXPECT_EQ(v2["name"], v1["name"]);
+  EXPECT_EQ(v2.size("b"), v1.size("b"));
+  EXPECT_EQ(v2.size("src"), v1.size("src"));
+  EXPECT_EQ(v2["dst"], v1["dst"]);
+}
+
+TEST_F(PushParser, error_on_feed) {
+  argparse::PushParser pp(*psr);
+  // Unknown option is detected immediately.
+  EXPECT_THROW(pp.feed("--unknown"), argparse::exception::ParseError);
+  
+  argparse::PushParser pp2(*psr);
+  pp2.feed("-b");
+  pp2.feed("1");
+  // "-b" requires 2 values, detected when next option comes.
+  EXPECT_THROW(pp2.feed("-a"), argparse::exception::ParseError);
+  
+  argparse::PushParser pp3(*psr);
+  pp3.feed("-n");
+  EXPECT_THROW(pp3.finish(), argparse::exception::ParseError);
+}
+
+TEST_F(PushParser, missing_sequence) {
+  argparse::PushParser pp(*psr);
+  pp.feed("-a");
+  pp.feed("only");
+  argparse::Values val = pp.finish();
+  // Same with parse_args, missing sequence argument is not set.
+  argparse::Values expect = psr->parse_args(argparse::Argv({"./test", "-a",
+                                                            "only"}));
+  EXPECT_EQ(expect.is_set("src"), val.is_set("src"));
+  EXPECT_EQ(expect.is_set("dst"), val.is_set("dst"));
+}
+
+TEST_F(PushParser, rest) {
+  argparse::PushParser pp(*psr);
+  for (auto& arg : argparse::Argv({"s", "d", "--", "ls", "-l"})) {
+    pp.feed(arg);
+  }
+  argparse::Values val = pp.finish();
+  EXPECT_EQ("d", val["dst"]);
+  
+  const argparse::ArgvSpan& rest = val.rest();
+  ASSERT_EQ(2, rest.size());
+  EXPECT_STREQ("ls", rest[0]);
+  EXPECT_STREQ("-l", rest[1]);
+  EXPECT_EQ(nullptr, rest.argv()[2]);
+}